@@ -0,0 +1,468 @@
+/**
+ * @file archive.c
+ * @brief Contenedor empaquetado .gsea para directorios de archivos pequeños
+ * @details El modo directorio clásico paga open/read/write/close (y fsync)
+ *          por archivo dos veces; aquí todas las entradas se procesan en
+ *          paralelo en memoria y se escriben en un solo archivo secuencial
+ *          con índice, así el costo de syscalls se amortiza sobre el
+ *          conjunto completo.
+ *
+ * Formato en disco:
+ *   [magic "GSEAPK01":8][entry_count:8 LE]
+ *   índice, por entrada: [name_len:2 LE][name][orig_size:8 LE][stored_size:8 LE]
+ *   payloads concatenados en el orden del índice
+ *
+ * Cada payload es el resultado del pipeline clásico (comprimir y/o
+ * encriptar) sobre la entrada completa; los offsets se derivan acumulando
+ * stored_size en el orden del índice.
+ */
+
+#include "archive.h"
+#include "file_manager.h"
+#include "stream.h"
+#include "concurrency/thread_pool.h"
+#include "utils/arena.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+static const uint8_t ARCHIVE_MAGIC[8] = { 'G', 'S', 'E', 'A', 'P', 'K', '0', '1' };
+
+/* Entrada del contenedor durante el empaquetado/desempaquetado */
+typedef struct {
+    const char *path;           /* Ruta de entrada (pack) o de salida (unpack) */
+    const char *name;           /* Nombre dentro del contenedor */
+    file_buffer_t payload;      /* Datos procesados (pack) o vista cruda (unpack) */
+    size_t orig_size;           /* Tamaño original de la entrada */
+    const gsea_config_t *config;
+    int *error_count;
+    pthread_mutex_t *error_mutex;
+    int status;
+} archive_entry_t;
+
+/**
+ * @brief Escribe todos los bytes al descriptor (write puede ser parcial)
+ */
+static int write_all(int fd, const uint8_t *data, size_t size) {
+    size_t written = 0;
+    while (written < size) {
+        ssize_t result = write(fd, data + written, size - written);
+        if (result < 0) {
+            LOG_ERROR("Write failed: %s", strerror(errno));
+            return GSEA_ERROR_FILE;
+        }
+        written += result;
+    }
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Registra un error de entrada bajo el mutex compartido
+ */
+static void entry_fail(archive_entry_t *entry) {
+    pthread_mutex_lock(entry->error_mutex);
+    (*entry->error_count)++;
+    pthread_mutex_unlock(entry->error_mutex);
+}
+
+/* ==============================
+ * Empaquetado
+ * ============================== */
+
+/**
+ * @brief Worker de empaquetado: lee una entrada y aplica el pipeline
+ */
+static void pack_entry_worker(void *arg) {
+    archive_entry_t *entry = (archive_entry_t *)arg;
+    file_buffer_t input = {0};
+
+    entry->status = map_file(entry->path, &input);
+    if (entry->status != GSEA_SUCCESS) {
+        entry->status = read_file(entry->path, &input);
+    }
+    if (entry->status != GSEA_SUCCESS) {
+        LOG_ERROR("Failed to read archive entry: %s", entry->path);
+        entry_fail(entry);
+        return;
+    }
+
+    entry->orig_size = input.size;
+    entry->status = process_chunk_forward(&input, &entry->payload,
+                                          entry->config);
+    free_buffer(&input);
+
+    if (entry->status != GSEA_SUCCESS) {
+        LOG_ERROR("Pipeline failed for archive entry: %s", entry->path);
+        entry_fail(entry);
+    }
+}
+
+/**
+ * @brief Empaqueta un directorio en un contenedor único
+ */
+int archive_pack(const gsea_config_t *config) {
+    if (!config) {
+        LOG_ERROR("Invalid configuration for archive_pack");
+        return GSEA_ERROR_ARGS;
+    }
+
+    arena_t *arena = arena_create(0);
+    if (!arena) {
+        return GSEA_ERROR_MEMORY;
+    }
+
+    char **files = NULL;
+    int file_count = 0;
+    int result = list_directory(config->input_path, arena, &files, &file_count);
+    if (result != GSEA_SUCCESS) {
+        LOG_ERROR("Failed to list directory: %s", config->input_path);
+        arena_destroy(arena);
+        return result;
+    }
+
+    if (file_count == 0) {
+        LOG_INFO("No files found in directory: %s", config->input_path);
+        arena_destroy(arena);
+        return GSEA_SUCCESS;
+    }
+
+    LOG_INFO("Packing %d files into %s", file_count, config->output_path);
+
+    pthread_mutex_t error_mutex = PTHREAD_MUTEX_INITIALIZER;
+    int error_count = 0;
+
+    archive_entry_t *entries =
+        arena_alloc(arena, file_count * sizeof(archive_entry_t));
+    if (!entries) {
+        arena_destroy(arena);
+        return GSEA_ERROR_MEMORY;
+    }
+    memset(entries, 0, file_count * sizeof(archive_entry_t));
+
+    int num_threads = MIN(file_count, config->num_threads);
+    thread_pool_t *pool = thread_pool_create(num_threads);
+    if (!pool) {
+        arena_destroy(arena);
+        return GSEA_ERROR_THREAD;
+    }
+
+    /* Procesar todas las entradas en paralelo, en memoria */
+    for (int i = 0; i < file_count; i++) {
+        const char *filename = strrchr(files[i], '/');
+        entries[i].path = files[i];
+        entries[i].name = filename ? filename + 1 : files[i];
+        entries[i].config = config;
+        entries[i].error_count = &error_count;
+        entries[i].error_mutex = &error_mutex;
+
+        if (thread_pool_add_task(pool, pack_entry_worker,
+                                 &entries[i]) != GSEA_SUCCESS) {
+            error_count++;
+        }
+    }
+
+    thread_pool_wait(pool);
+    thread_pool_destroy(pool);
+
+    if (error_count > 0) {
+        LOG_ERROR("Packing aborted: %d entries failed", error_count);
+        for (int i = 0; i < file_count; i++) {
+            free(entries[i].payload.data);
+        }
+        arena_destroy(arena);
+        pthread_mutex_destroy(&error_mutex);
+        return GSEA_ERROR_FILE;
+    }
+
+    /* Escribir el contenedor en una sola secuencia: header, índice, payloads */
+    int fd = open(config->output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOG_ERROR("Failed to create archive '%s': %s", config->output_path,
+                  strerror(errno));
+        result = GSEA_ERROR_FILE;
+        goto cleanup;
+    }
+
+    uint8_t header[16];
+    memcpy(header, ARCHIVE_MAGIC, 8);
+    uint64_t count64 = (uint64_t)file_count;
+    for (int b = 0; b < 8; b++) {
+        header[8 + b] = (uint8_t)(count64 >> (8 * b));
+    }
+    result = write_all(fd, header, sizeof(header));
+
+    for (int i = 0; result == GSEA_SUCCESS && i < file_count; i++) {
+        uint8_t meta[2 + 16];
+        size_t name_len = strlen(entries[i].name);
+        if (name_len >= MAX_PATH_LENGTH) {
+            LOG_ERROR("Entry name too long: %s", entries[i].name);
+            result = GSEA_ERROR_FILE;
+            break;
+        }
+        meta[0] = (uint8_t)(name_len);
+        meta[1] = (uint8_t)(name_len >> 8);
+        uint64_t orig = (uint64_t)entries[i].orig_size;
+        uint64_t stored = (uint64_t)entries[i].payload.size;
+        for (int b = 0; b < 8; b++) {
+            meta[2 + b] = (uint8_t)(orig >> (8 * b));
+            meta[10 + b] = (uint8_t)(stored >> (8 * b));
+        }
+        result = write_all(fd, meta, 2);
+        if (result == GSEA_SUCCESS) {
+            result = write_all(fd, (const uint8_t *)entries[i].name, name_len);
+        }
+        if (result == GSEA_SUCCESS) {
+            result = write_all(fd, meta + 2, 16);
+        }
+    }
+
+    for (int i = 0; result == GSEA_SUCCESS && i < file_count; i++) {
+        result = write_all(fd, entries[i].payload.data,
+                           entries[i].payload.size);
+    }
+
+    /* Un solo fsync cubre el conjunto completo */
+    if (result == GSEA_SUCCESS &&
+        file_manager_get_fsync_policy() == FSYNC_PER_FILE && fsync(fd) < 0) {
+        LOG_ERROR("Failed to sync archive '%s': %s", config->output_path,
+                  strerror(errno));
+    }
+    close(fd);
+
+    if (result == GSEA_SUCCESS) {
+        LOG_INFO("Archive written: %d entries", file_count);
+    }
+
+cleanup:
+    for (int i = 0; i < file_count; i++) {
+        free(entries[i].payload.data);
+    }
+    arena_destroy(arena);
+    pthread_mutex_destroy(&error_mutex);
+    return result;
+}
+
+/* ==============================
+ * Desempaquetado
+ * ============================== */
+
+/**
+ * @brief Worker de desempaquetado: pipeline inverso + escritura de la entrada
+ */
+static void unpack_entry_worker(void *arg) {
+    archive_entry_t *entry = (archive_entry_t *)arg;
+    file_buffer_t restored = {0};
+
+    entry->status = process_chunk_reverse(&entry->payload, &restored,
+                                          entry->config);
+    if (entry->status != GSEA_SUCCESS) {
+        LOG_ERROR("Pipeline failed for archive entry: %s", entry->name);
+        entry_fail(entry);
+        return;
+    }
+
+    entry->status = write_file(entry->path, &restored);
+    free(restored.data);
+    if (entry->status != GSEA_SUCCESS) {
+        LOG_ERROR("Failed to write archive entry: %s", entry->path);
+        entry_fail(entry);
+    }
+}
+
+/**
+ * @brief Lee un entero little-endian de 64 bits
+ */
+static uint64_t read_le64(const uint8_t *p) {
+    uint64_t value = 0;
+    for (int b = 7; b >= 0; b--) {
+        value = (value << 8) | p[b];
+    }
+    return value;
+}
+
+/**
+ * @brief Detecta si un archivo es un contenedor .gsea
+ */
+bool archive_is_archive(const char *path) {
+    if (!path) {
+        return false;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    uint8_t magic[8];
+    ssize_t got = read(fd, magic, sizeof(magic));
+    close(fd);
+
+    return got == (ssize_t)sizeof(magic) &&
+           memcmp(magic, ARCHIVE_MAGIC, sizeof(magic)) == 0;
+}
+
+/**
+ * @brief Desempaqueta un contenedor en un directorio
+ */
+int archive_unpack(const gsea_config_t *config) {
+    if (!config) {
+        LOG_ERROR("Invalid configuration for archive_unpack");
+        return GSEA_ERROR_ARGS;
+    }
+
+    file_buffer_t archive = {0};
+    int result = map_file(config->input_path, &archive);
+    if (result != GSEA_SUCCESS) {
+        result = read_file(config->input_path, &archive);
+    }
+    if (result != GSEA_SUCCESS) {
+        LOG_ERROR("Failed to read archive: %s", config->input_path);
+        return result;
+    }
+
+    if (archive.size < 16 ||
+        memcmp(archive.data, ARCHIVE_MAGIC, 8) != 0) {
+        LOG_ERROR("Not a GSEA archive: %s", config->input_path);
+        free_buffer(&archive);
+        return GSEA_ERROR_FILE;
+    }
+
+    uint64_t entry_count = read_le64(archive.data + 8);
+    if (entry_count == 0 || entry_count > (archive.size - 16) / 18) {
+        LOG_ERROR("Corrupt archive index (entry count %llu)",
+                  (unsigned long long)entry_count);
+        free_buffer(&archive);
+        return GSEA_ERROR_FILE;
+    }
+
+    if (!is_directory(config->output_path)) {
+        result = create_directory(config->output_path);
+        if (result != GSEA_SUCCESS) {
+            free_buffer(&archive);
+            return result;
+        }
+    }
+
+    arena_t *arena = arena_create(0);
+    if (!arena) {
+        free_buffer(&archive);
+        return GSEA_ERROR_MEMORY;
+    }
+
+    archive_entry_t *entries =
+        arena_alloc(arena, entry_count * sizeof(archive_entry_t));
+    if (!entries) {
+        arena_destroy(arena);
+        free_buffer(&archive);
+        return GSEA_ERROR_MEMORY;
+    }
+    memset(entries, 0, entry_count * sizeof(archive_entry_t));
+
+    pthread_mutex_t error_mutex = PTHREAD_MUTEX_INITIALIZER;
+    int error_count = 0;
+
+    /* Parsear el índice validando límites contra el tamaño del archivo */
+    size_t pos = 16;
+    size_t payload_total = 0;
+    for (uint64_t i = 0; i < entry_count; i++) {
+        if (pos + 2 > archive.size) goto corrupt;
+        size_t name_len = archive.data[pos] | (archive.data[pos + 1] << 8);
+        pos += 2;
+        if (name_len == 0 || name_len >= MAX_PATH_LENGTH ||
+            pos + name_len + 16 > archive.size) {
+            goto corrupt;
+        }
+
+        char name[MAX_PATH_LENGTH];
+        memcpy(name, archive.data + pos, name_len);
+        name[name_len] = '\0';
+        pos += name_len;
+
+        /* Rechazar nombres con separadores: el índice es plano */
+        if (strchr(name, '/') != NULL) goto corrupt;
+
+        entries[i].orig_size = read_le64(archive.data + pos);
+        entries[i].payload.size = read_le64(archive.data + pos + 8);
+        pos += 16;
+
+        /* Validar cada tamaño contra lo que queda del archivo: sumar
+           valores de 64 bits sin tope permitiría desbordar payload_total
+           y burlar el check global de límites de más abajo */
+        if (entries[i].payload.size > archive.size - payload_total) {
+            goto corrupt;
+        }
+        payload_total += entries[i].payload.size;
+
+        entries[i].name = arena_strdup(arena, name);
+
+        char output_path[MAX_PATH_LENGTH];
+        int written = snprintf(output_path, MAX_PATH_LENGTH, "%s/%s",
+                               config->output_path, name);
+        if (written < 0 || written >= (int)MAX_PATH_LENGTH) goto corrupt;
+        entries[i].path = arena_strdup(arena, output_path);
+
+        if (!entries[i].name || !entries[i].path) {
+            result = GSEA_ERROR_MEMORY;
+            goto cleanup;
+        }
+
+        entries[i].config = config;
+        entries[i].error_count = &error_count;
+        entries[i].error_mutex = &error_mutex;
+    }
+
+    if (pos + payload_total > archive.size) goto corrupt;
+
+    /* Los payloads son vistas dentro del mapeo, sin copias */
+    for (uint64_t i = 0; i < entry_count; i++) {
+        entries[i].payload.data = archive.data + pos;
+        entries[i].payload.capacity = entries[i].payload.size;
+        pos += entries[i].payload.size;
+    }
+
+    LOG_INFO("Unpacking %llu entries from %s",
+             (unsigned long long)entry_count, config->input_path);
+
+    {
+        int num_threads = (int)MIN(entry_count, (uint64_t)config->num_threads);
+        thread_pool_t *pool = thread_pool_create(num_threads);
+        if (!pool) {
+            result = GSEA_ERROR_THREAD;
+            goto cleanup;
+        }
+
+        for (uint64_t i = 0; i < entry_count; i++) {
+            if (thread_pool_add_task(pool, unpack_entry_worker,
+                                     &entries[i]) != GSEA_SUCCESS) {
+                error_count++;
+            }
+        }
+
+        thread_pool_wait(pool);
+        thread_pool_destroy(pool);
+    }
+
+    if (error_count > 0) {
+        LOG_ERROR("Unpacking completed with %d errors", error_count);
+        result = GSEA_ERROR_FILE;
+    } else {
+        LOG_INFO("All entries unpacked successfully");
+        result = GSEA_SUCCESS;
+    }
+    goto cleanup;
+
+corrupt:
+    LOG_ERROR("Corrupt archive index: %s", config->input_path);
+    result = GSEA_ERROR_FILE;
+
+cleanup:
+    arena_destroy(arena);
+    free_buffer(&archive);
+    pthread_mutex_destroy(&error_mutex);
+    return result;
+}
@@ -0,0 +1,36 @@
+/**
+ * @file archive.h
+ * @brief Contenedor empaquetado .gsea para directorios de archivos pequeños
+ */
+
+#ifndef ARCHIVE_H
+#define ARCHIVE_H
+
+#include "common.h"
+
+/**
+ * @brief Detecta si un archivo es un contenedor .gsea (magic GSEAPK01)
+ * @param path Ruta del archivo a examinar
+ * @return true si el archivo empieza con el magic del contenedor
+ */
+bool archive_is_archive(const char *path);
+
+/**
+ * @brief Empaqueta un directorio en un contenedor único
+ * @details Cada entrada pasa por el mismo pipeline del modo clásico
+ *          (comprimir y/o encriptar) en paralelo sobre el pool; el
+ *          contenedor se escribe en una sola secuencia con un índice,
+ *          amortizando open/write/fsync sobre todo el conjunto.
+ * @param config Configuración global (input_path directorio, output_path archivo)
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int archive_pack(const gsea_config_t *config);
+
+/**
+ * @brief Desempaqueta un contenedor en un directorio
+ * @param config Configuración global (input_path contenedor, output_path directorio)
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int archive_unpack(const gsea_config_t *config);
+
+#endif /* ARCHIVE_H */
@@ -29,7 +29,7 @@
 #define MAX_PATH_LENGTH 4096
 #define MAX_KEY_LENGTH 256
 #define BUFFER_SIZE 8192
-#define MAX_THREADS 16
+#define MAX_THREADS 256    /* Límite de sanidad, no de diseño */
 
 /* ==============================
  * Enumeraciones de operaciones
@@ -49,11 +49,16 @@ typedef enum {
     COMP_LZ77,
     COMP_HUFFMAN,
     COMP_RLE,
-    COMP_LZW        
+    COMP_LZW,
+    COMP_AUTO,      /* Sondea el contenido y elige; el algoritmo real viaja
+                       en el header de salida */
+    COMP_STORE      /* Enmarca sin comprimir: entradas ya comprimidas y red
+                       de seguridad cuando un códec expande */
 } compression_algorithm_t;
 
 typedef enum {
     ENC_AES128,
+    ENC_AES128_CTR,
     ENC_CHACHA20,
     ENC_SALSA20,
     ENC_DES,
@@ -61,12 +66,22 @@ typedef enum {
     ENC_RC4         
 } encryption_algorithm_t;
 
+/* ==============================
+ * Política de durabilidad
+ * ============================== */
+typedef enum {
+    FSYNC_PER_FILE,     /* fsync tras cada archivo escrito (por defecto) */
+    FSYNC_END,          /* Un solo syncfs al final del trabajo */
+    FSYNC_NONE          /* Sin sincronización explícita */
+} fsync_policy_t;
+
 /* ==============================
  * Estructura de configuración global
  * ============================== */
 typedef struct {
     operation_t operations;
     compression_algorithm_t comp_alg;
+    int comp_level;     /* Nivel de compresión 1..9 (velocidad <-> ratio) */
     encryption_algorithm_t enc_alg;
     char input_path[MAX_PATH_LENGTH];
     char output_path[MAX_PATH_LENGTH];
@@ -74,6 +89,22 @@ typedef struct {
     size_t key_len;
     int num_threads;
     bool verbose;
+    bool stream;        /* Pipeline por chunks con memoria acotada */
+    bool streaming_io;  /* fadvise: no contaminar la caché de páginas */
+    bool io_uring;      /* Motor de E/S io_uring (fallback POSIX) */
+    fsync_policy_t fsync_policy;  /* Cuándo sincronizar salidas al disco */
+    bool stats;         /* Desglose por etapa del pipeline */
+    bool recursive;     /* Recorrer subdirectorios en modo directorio */
+    bool extract_range; /* Extraer solo un rango del archivo comprimido */
+    uint64_t range_offset;  /* Offset del rango en datos sin comprimir */
+    uint64_t range_length;  /* Longitud del rango */
+    char dict_path[MAX_PATH_LENGTH];  /* Diccionario preset (lz77/lzw) */
+    bool incremental;   /* Saltar archivos sin cambios según el manifiesto */
+    bool force;         /* Reprocesar todo aunque el manifiesto coincida */
+    bool daemon;        /* Servir trabajos por socket unix (pool caliente) */
+    bool remote;        /* Enviar este trabajo al daemon en vez de local */
+    bool daemon_stop;   /* Pedir al daemon que termine */
+    char socket_path[MAX_PATH_LENGTH];  /* Socket unix del daemon */
 } gsea_config_t;
 
 /* ==============================
@@ -83,6 +114,7 @@ typedef struct {
     uint8_t *data;
     size_t size;
     size_t capacity;
+    bool mapped;        /* true si data proviene de mmap (liberar con munmap) */
 } file_buffer_t;
 
 /* ==============================
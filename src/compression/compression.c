@@ -4,14 +4,256 @@
  */
 
 #include "compression.h"
+#include "../utils/buffer_pool.h"
 #include "lz77.h"
 #include "huffman.h"
 #include "rle.h"
 #include "../common.h"
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "lzw.h"
 
+/* ==============================
+ * Almacenamiento sin compresión (store)
+ * ============================== */
+
+/* Envoltorio store: [magic:8][payload crudo]. Para entradas ya comprimidas
+   (.jpg, .zst) donde un códec real solo quema CPU y expande, y como red de
+   seguridad del guardián de expansión: el peor caso de compresión queda a
+   velocidad de memcpy. El magic hace el formato autodescriptivo, así la
+   descompresión funciona sin importar el --comp-alg del caller */
+static const uint8_t STORE_MAGIC[8] = { 'G', 'S', 'E', 'A', 'R', 'W', '0', '1' };
+#define STORE_HEADER_SIZE 8
+
+/* Guardián de expansión: si el códec no baja del 98% del original, su
+   salida se descarta y se almacena crudo */
+#define STORE_GUARD_NUM 98
+#define STORE_GUARD_DEN 100
+
+/**
+ * @brief Enmarca la entrada sin modificar bajo el magic store
+ */
+static int store_raw(const file_buffer_t *input, file_buffer_t *output) {
+    output->size = 0;
+    if (buffer_reserve(output, STORE_HEADER_SIZE + input->size)
+            != GSEA_SUCCESS) {
+        return GSEA_ERROR_MEMORY;
+    }
+    memcpy(output->data, STORE_MAGIC, 8);
+    memcpy(output->data + STORE_HEADER_SIZE, input->data, input->size);
+    output->size = STORE_HEADER_SIZE + input->size;
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief ¿El stream lleva el magic store?
+ */
+static bool is_store(const file_buffer_t *input) {
+    return input->size >= STORE_HEADER_SIZE &&
+           memcmp(input->data, STORE_MAGIC, 8) == 0;
+}
+
+/**
+ * @brief Recupera el payload crudo de un stream store
+ */
+static int unstore_raw(const file_buffer_t *input, file_buffer_t *output) {
+    size_t payload = input->size - STORE_HEADER_SIZE;
+    output->size = 0;
+    if (buffer_reserve(output, payload ? payload : 1) != GSEA_SUCCESS) {
+        return GSEA_ERROR_MEMORY;
+    }
+    memcpy(output->data, input->data + STORE_HEADER_SIZE, payload);
+    output->size = payload;
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Sustituye la salida por el formato store si el códec expandió
+ * @details Se aplica tras cada compresión exitosa: la salida del códec ya
+ *          está en output y solo se reemplaza si no vale lo que cuesta
+ *          decodificarla.
+ */
+static int apply_store_guard(const file_buffer_t *input,
+                             file_buffer_t *output) {
+    if (output->size * STORE_GUARD_DEN <
+        input->size * STORE_GUARD_NUM) {
+        return GSEA_SUCCESS;
+    }
+    /* DEBUG y no INFO: en modo multibloque el guardián corre por bloque y
+       un archivo incompresible grande generaría una línea por bloque */
+    LOG_DEBUG("Expansion guard: %zu -> %zu bytes, storing raw instead",
+              input->size, output->size);
+    return store_raw(input, output);
+}
+
+/* ==============================
+ * Selección automática de algoritmo
+ * ============================== */
+
+/* Envoltorio auto: [magic:8][algoritmo:1][payload]. El algoritmo elegido
+   viaja en el header, así la descompresión no depende del flag del caller */
+static const uint8_t AUTO_MAGIC[8] = { 'G', 'S', 'E', 'A', 'A', 'L', '0', '1' };
+#define AUTO_HEADER_SIZE 9
+
+/* Parámetros del sondeo: hasta 4 ventanas de 64 KB repartidas */
+#define PROBE_WINDOW (64u * 1024u)
+#define PROBE_WINDOWS 4
+#define PROBE_HASH_BITS 13
+
+static const char *algorithm_name(compression_algorithm_t algorithm) {
+    switch (algorithm) {
+        case COMP_LZ77: return "lz77";
+        case COMP_HUFFMAN: return "huffman";
+        case COMP_RLE: return "rle";
+        case COMP_LZW: return "lzw";
+        case COMP_STORE: return "store";
+        default: return "?";
+    }
+}
+
+/**
+ * @brief Elige el algoritmo sondeando entropía, runs y matches del contenido
+ * @details Muestrea ventanas repartidas por el archivo: histograma de bytes
+ *          (entropía de Shannon), fracción de bytes iguales al anterior
+ *          (runs) y tasa de repetición de 4-gramas vía una tabla hash chica
+ *          (proxy barato de matches LZ). Datos muy runny van a RLE, con
+ *          muchos matches a LZ77, texto moderadamente repetitivo a LZW y
+ *          el resto (incluida la entropía casi máxima) a Huffman, cuyo
+ *          peor caso es el más benigno de los códecs. Entropía casi máxima
+ *          sin matches (datos ya comprimidos o cifrados) va a store: ahí
+ *          ningún códec gana y el enmarcado crudo cuesta un memcpy.
+ */
+static compression_algorithm_t probe_algorithm(const file_buffer_t *input) {
+    if (input->size < 4 * PROBE_WINDOW / 64) {
+        return COMP_LZ77;   /* Muy chico para estadísticas: el por defecto */
+    }
+
+    uint64_t freq[256] = {0};
+    size_t total = 0, run_hits = 0, match_hits = 0, match_probes = 0;
+
+    size_t windows = (input->size + PROBE_WINDOW - 1) / PROBE_WINDOW;
+    windows = MIN(windows, (size_t)PROBE_WINDOWS);
+    size_t stride = (windows > 1)
+                        ? (input->size - PROBE_WINDOW) / (windows - 1)
+                        : 0;
+
+    for (size_t w = 0; w < windows; w++) {
+        size_t start = w * stride;
+        size_t n = MIN((size_t)PROBE_WINDOW, input->size - start);
+        const uint8_t *p = input->data + start;
+
+        for (size_t i = 0; i < n; i++) {
+            freq[p[i]]++;
+            if (i > 0 && p[i] == p[i - 1]) {
+                run_hits++;
+            }
+        }
+        total += n;
+
+        /* Repetición de 4-gramas dentro de la ventana */
+        uint32_t table[1u << PROBE_HASH_BITS];
+        memset(table, 0xFF, sizeof(table));
+        for (size_t i = 0; i + 4 <= n; i++) {
+            uint32_t v;
+            memcpy(&v, p + i, 4);
+            uint32_t h = (v * 2654435761u) >> (32 - PROBE_HASH_BITS);
+            uint32_t cand = table[h];
+            if (cand != UINT32_MAX && memcmp(p + cand, p + i, 4) == 0) {
+                match_hits++;
+            }
+            table[h] = (uint32_t)i;
+            match_probes++;
+        }
+    }
+
+    double entropy = 0.0;
+    for (int s = 0; s < 256; s++) {
+        if (freq[s]) {
+            double pr = (double)freq[s] / (double)total;
+            entropy -= pr * log2(pr);
+        }
+    }
+    double run_frac = (double)run_hits / (double)total;
+    double match_frac = match_probes
+                            ? (double)match_hits / (double)match_probes
+                            : 0.0;
+
+    compression_algorithm_t chosen;
+    if (run_frac >= 0.40) {
+        chosen = COMP_RLE;
+    } else if (entropy >= 7.95 && match_frac < 0.10) {
+        /* Ya comprimido/cifrado: ningún códec va a ganar nada */
+        chosen = COMP_STORE;
+    } else if (match_frac >= 0.25) {
+        chosen = COMP_LZ77;
+    } else if (entropy <= 7.0 && match_frac >= 0.10) {
+        chosen = COMP_LZW;
+    } else {
+        chosen = COMP_HUFFMAN;
+    }
+
+    LOG_INFO("Auto probe: %.2f bits/byte, %.0f%% runs, %.0f%% matches -> %s",
+             entropy, run_frac * 100.0, match_frac * 100.0,
+             algorithm_name(chosen));
+    return chosen;
+}
+
+/**
+ * @brief Comprime con el algoritmo sondeado y antepone el envoltorio auto
+ */
+static int compress_auto(const file_buffer_t *input, file_buffer_t *output,
+                         thread_pool_t *pool) {
+    compression_algorithm_t chosen = probe_algorithm(input);
+
+    /* El formato store ya es autodescriptivo: sin envoltorio auto */
+    if (chosen == COMP_STORE) {
+        return store_raw(input, output);
+    }
+
+    file_buffer_t payload = {0};
+    int result = pool
+                     ? compress_data_parallel(input, &payload, chosen, pool)
+                     : compress_data(input, &payload, chosen);
+    if (result != GSEA_SUCCESS) {
+        return result;
+    }
+
+    output->size = 0;
+    if (buffer_reserve(output, AUTO_HEADER_SIZE + payload.size)
+            != GSEA_SUCCESS) {
+        free(payload.data);
+        return GSEA_ERROR_MEMORY;
+    }
+    memcpy(output->data, AUTO_MAGIC, 8);
+    output->data[8] = (uint8_t)chosen;
+    memcpy(output->data + AUTO_HEADER_SIZE, payload.data, payload.size);
+    output->size = AUTO_HEADER_SIZE + payload.size;
+    free(payload.data);
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Destapa el envoltorio auto si está presente (vista sin copia)
+ */
+static bool unwrap_auto(const file_buffer_t *input, file_buffer_t *view,
+                        compression_algorithm_t *algorithm) {
+    if (input->size <= AUTO_HEADER_SIZE ||
+        memcmp(input->data, AUTO_MAGIC, 8) != 0) {
+        return false;
+    }
+    uint8_t alg = input->data[8];
+    if (alg > COMP_LZW) {
+        return false;
+    }
+    view->data = input->data + AUTO_HEADER_SIZE;
+    view->size = input->size - AUTO_HEADER_SIZE;
+    view->capacity = view->size;
+    view->mapped = false;
+    *algorithm = (compression_algorithm_t)alg;
+    return true;
+}
+
 /**
  * @brief Comprime datos usando el algoritmo especificado
  */
@@ -21,104 +263,511 @@ int compress_data(const file_buffer_t *input, file_buffer_t *output,
         LOG_ERROR("Invalid parameters for compress_data");
         return GSEA_ERROR_ARGS;
     }
-    
+
+    if (algorithm == COMP_AUTO) {
+        return compress_auto(input, output, NULL);
+    }
+
+    int result;
     switch (algorithm) {
+        case COMP_STORE:
+            return store_raw(input, output);
+
         case COMP_LZ77:
-            return lz77_compress(input, output);
-            
+            result = lz77_compress(input, output);
+            break;
+
         case COMP_HUFFMAN: {
-            /* Huffman usa una estructura intermedia, necesitamos adaptar */
-            huffman_compressed_t *compressed = NULL;
-            int result = huffman_compress(input->data, input->size, &compressed);
-            
-            if (result != HUFFMAN_SUCCESS) {
-                LOG_ERROR("Huffman compression failed: %d", result);
-                return GSEA_ERROR_COMPRESSION;
-            }
-            
-            /* Serializar a file_buffer_t */
-            uint8_t *serialized = NULL;
-            size_t serialized_size = 0;
-            result = huffman_serialize(compressed, &serialized, &serialized_size);
-            
-            if (result != HUFFMAN_SUCCESS) {
-                huffman_free_compressed(compressed);
-                LOG_ERROR("Huffman serialization failed: %d", result);
+            /* Ruta directa: codifica en el formato serializado sin pasar
+               por la estructura intermedia */
+            int huff = huffman_encode(input, output);
+            if (huff != HUFFMAN_SUCCESS) {
+                LOG_ERROR("Huffman compression failed: %d", huff);
                 return GSEA_ERROR_COMPRESSION;
             }
-            
-            /* Copiar al buffer de salida */
-            output->data = serialized;
-            output->size = serialized_size;
-            output->capacity = serialized_size;
-            
-            huffman_free_compressed(compressed);
-            return GSEA_SUCCESS;
+            result = GSEA_SUCCESS;
+            break;
         }
-            
+
         case COMP_RLE: {
-            /* RLE usa una estructura intermedia similar a Huffman */
-            rle_compressed_t *compressed = NULL;
-            int result = rle_compress(input->data, input->size, &compressed);
-            
-            if (result != RLE_SUCCESS) {
-                LOG_ERROR("RLE compression failed: %d", result);
-                return GSEA_ERROR_COMPRESSION;
-            }
-            
-            /* Serializar a file_buffer_t */
-            uint8_t *serialized = NULL;
-            size_t serialized_size = 0;
-            result = rle_serialize(compressed, &serialized, &serialized_size);
-            
-            if (result != RLE_SUCCESS) {
-                rle_free_compressed(compressed);
-                LOG_ERROR("RLE serialization failed: %d", result);
+            int rle = rle_encode(input, output);
+            if (rle != RLE_SUCCESS) {
+                LOG_ERROR("RLE compression failed: %d", rle);
                 return GSEA_ERROR_COMPRESSION;
             }
-            
-            /* Copiar al buffer de salida */
-            output->data = serialized;
-            output->size = serialized_size;
-            output->capacity = serialized_size;
-            
-            rle_free_compressed(compressed);
-            return GSEA_SUCCESS;
+            result = GSEA_SUCCESS;
+            break;
         }
+
         case COMP_LZW: {
-            /* LZW usa estructura intermedia similar a Huffman */
-            lzw_compressed_t *compressed = NULL;
-            int result = lzw_compress(input->data, input->size, &compressed);
-            
-            if (result != LZW_SUCCESS) {
-                LOG_ERROR("LZW compression failed: %d", result);
-                return GSEA_ERROR_COMPRESSION;
-            }
-            
-            /* Serializar a file_buffer_t */
-            uint8_t *serialized = NULL;
-            size_t serialized_size = 0;
-            result = lzw_serialize(compressed, &serialized, &serialized_size);
-            
-            if (result != LZW_SUCCESS) {
-                lzw_free_compressed(compressed);
-                LOG_ERROR("LZW serialization failed: %d", result);
+            int lzw = lzw_encode(input, output);
+            if (lzw != LZW_SUCCESS) {
+                LOG_ERROR("LZW compression failed: %d", lzw);
                 return GSEA_ERROR_COMPRESSION;
             }
-            
-            /* Copiar al buffer de salida */
-            output->data = serialized;
-            output->size = serialized_size;
-            output->capacity = serialized_size;
-            
-            lzw_free_compressed(compressed);
-            return GSEA_SUCCESS;
+            result = GSEA_SUCCESS;
+            break;
         }
-            
+
         default:
             LOG_ERROR("Unknown compression algorithm: %d", algorithm);
             return GSEA_ERROR_ARGS;
     }
+
+    if (result != GSEA_SUCCESS) {
+        return result;
+    }
+
+    /* Si el códec expandió (entrada ya comprimida, runs cortos, etc.) se
+       descarta su salida y se almacena crudo */
+    return apply_store_guard(input, output);
+}
+
+/* ==============================
+ * Compresión paralela por bloques
+ * ============================== */
+
+/* Magic del formato multi-bloque */
+static const uint8_t MULTIBLOCK_MAGIC[8] = { 'G', 'S', 'E', 'A', 'M', 'B', '0', '1' };
+
+/* Tarea de compresión/descompresión de un bloque */
+typedef struct {
+    file_buffer_t input;            /* Vista sobre el bloque (no posee data) */
+    file_buffer_t output;           /* Resultado del bloque */
+    uint8_t *dest;                  /* Destino directo (solo descompresión) */
+    size_t dest_capacity;
+    compression_algorithm_t algorithm;
+    int result;
+} block_task_t;
+
+static void compress_block_worker(void *arg) {
+    block_task_t *task = (block_task_t *)arg;
+    task->result = compress_data(&task->input, &task->output, task->algorithm);
+}
+
+static void decompress_block_worker(void *arg) {
+    block_task_t *task = (block_task_t *)arg;
+    task->result = decompress_data(&task->input, &task->output, task->algorithm);
+    if (task->result == GSEA_SUCCESS) {
+        if (task->output.size > task->dest_capacity) {
+            task->result = GSEA_ERROR_COMPRESSION;
+        } else {
+            memcpy(task->dest, task->output.data, task->output.size);
+        }
+        free(task->output.data);
+        task->output.data = NULL;
+    }
+}
+
+static void store32_le(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)(v);
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t load32_le(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/**
+ * @brief Comprime dividiendo la entrada en bloques independientes en paralelo
+ */
+int compress_data_parallel(const file_buffer_t *input, file_buffer_t *output,
+                           compression_algorithm_t algorithm, thread_pool_t *pool) {
+    if (!input || !output) {
+        LOG_ERROR("Invalid parameters for compress_data_parallel");
+        return GSEA_ERROR_ARGS;
+    }
+
+    /* Selección automática: sondear primero y comprimir con el elegido */
+    if (algorithm == COMP_AUTO) {
+        return compress_auto(input, output, pool);
+    }
+
+    /* Store: el enmarcado crudo no gana nada con bloques */
+    if (algorithm == COMP_STORE) {
+        return store_raw(input, output);
+    }
+
+    /* Entradas pequeñas o sin pool: formato monolítico clásico */
+    if (!pool || input->size < COMP_PARALLEL_THRESHOLD) {
+        return compress_data(input, output, algorithm);
+    }
+
+    /* Huffman: las dos fases (histograma y emisión) se paralelizan sobre
+       un único árbol compartido en lugar de un árbol por bloque — mejor
+       ratio y la salida es HUF2 estándar, sin el envoltorio multibloque */
+    if (algorithm == COMP_HUFFMAN) {
+        int result = huffman_encode_parallel(input, output, pool);
+        if (result != HUFFMAN_SUCCESS) {
+            LOG_ERROR("Huffman compression failed: %d", result);
+            return GSEA_ERROR_COMPRESSION;
+        }
+        return apply_store_guard(input, output);
+    }
+
+    size_t block_count = (input->size + COMP_BLOCK_SIZE - 1) / COMP_BLOCK_SIZE;
+    block_task_t *tasks = calloc(block_count, sizeof(block_task_t));
+    if (!tasks) {
+        LOG_ERROR("Memory allocation failed for block tasks");
+        return GSEA_ERROR_MEMORY;
+    }
+
+    LOG_INFO("Parallel compression: %zu blocks of %u KB",
+             block_count, COMP_BLOCK_SIZE / 1024);
+
+    /* Encolar un bloque por tarea; cada bloque es una vista sin copia */
+    int result = GSEA_SUCCESS;
+    for (size_t i = 0; i < block_count; i++) {
+        size_t offset = i * COMP_BLOCK_SIZE;
+        tasks[i].input.data = input->data + offset;
+        tasks[i].input.size = MIN(COMP_BLOCK_SIZE, input->size - offset);
+        tasks[i].input.capacity = tasks[i].input.size;
+        tasks[i].algorithm = algorithm;
+        tasks[i].result = GSEA_ERROR_COMPRESSION;
+
+        if (thread_pool_add_task(pool, compress_block_worker, &tasks[i]) != GSEA_SUCCESS) {
+            /* Ejecutar en línea si la cola falla */
+            compress_block_worker(&tasks[i]);
+        }
+    }
+
+    thread_pool_wait(pool);
+
+    /* Calcular tamaño total y validar resultados */
+    size_t payload_size = 0;
+    for (size_t i = 0; i < block_count; i++) {
+        if (tasks[i].result != GSEA_SUCCESS) {
+            LOG_ERROR("Block %zu compression failed", i);
+            result = GSEA_ERROR_COMPRESSION;
+        }
+        payload_size += tasks[i].output.size;
+    }
+
+    if (result == GSEA_SUCCESS) {
+        /* Header: magic(8) + tamaño original(8 LE) + block_size(4) +
+           block_count(4) + tabla de tamaños comprimidos (4 LE c/u) */
+        size_t header_size = 8 + 8 + 4 + 4 + block_count * 4;
+        output->size = 0;
+
+        if (buffer_reserve(output, header_size + payload_size)
+                != GSEA_SUCCESS) {
+            result = GSEA_ERROR_MEMORY;
+        } else {
+            memcpy(output->data, MULTIBLOCK_MAGIC, 8);
+            output->size = 8;
+
+            uint64_t orig_size = input->size;
+            for (int b = 0; b < 8; b++) {
+                output->data[output->size++] = (uint8_t)(orig_size >> (b * 8));
+            }
+            store32_le(output->data + output->size, COMP_BLOCK_SIZE);
+            output->size += 4;
+            store32_le(output->data + output->size, (uint32_t)block_count);
+            output->size += 4;
+
+            for (size_t i = 0; i < block_count; i++) {
+                store32_le(output->data + output->size, (uint32_t)tasks[i].output.size);
+                output->size += 4;
+            }
+            for (size_t i = 0; i < block_count; i++) {
+                memcpy(output->data + output->size, tasks[i].output.data,
+                       tasks[i].output.size);
+                output->size += tasks[i].output.size;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < block_count; i++) {
+        free(tasks[i].output.data);
+    }
+    free(tasks);
+
+    if (result != GSEA_SUCCESS && output->data) {
+        free(output->data);
+        output->data = NULL;
+    }
+
+    /* El guardián también cubre el formato multi-bloque: si los bloques
+       no comprimieron, el header y la tabla solo agrandan el archivo */
+    if (result == GSEA_SUCCESS) {
+        result = apply_store_guard(input, output);
+    }
+
+    return result;
+}
+
+/**
+ * @brief Descomprime un stream multi-bloque en paralelo
+ */
+int decompress_data_parallel(const file_buffer_t *input, file_buffer_t *output,
+                             compression_algorithm_t algorithm, thread_pool_t *pool) {
+    if (!input || !output) {
+        LOG_ERROR("Invalid parameters for decompress_data_parallel");
+        return GSEA_ERROR_ARGS;
+    }
+
+    /* Envoltorio auto: el algoritmo real viene en el header */
+    file_buffer_t view;
+    if (unwrap_auto(input, &view, &algorithm)) {
+        return decompress_data_parallel(&view, output, algorithm, pool);
+    }
+
+    /* Formato store: recuperar el payload crudo (paralelizar un memcpy
+       no aporta nada) */
+    if (is_store(input)) {
+        return unstore_raw(input, output);
+    }
+
+    /* Formato monolítico clásico (sin magic multi-bloque) */
+    if (input->size < 24 || memcmp(input->data, MULTIBLOCK_MAGIC, 8) != 0) {
+        return decompress_data(input, output, algorithm);
+    }
+
+    /* Parsear header */
+    size_t pos = 8;
+    uint64_t orig_size = 0;
+    for (int b = 0; b < 8; b++) {
+        orig_size |= ((uint64_t)input->data[pos++]) << (b * 8);
+    }
+    uint32_t block_size = load32_le(input->data + pos);
+    pos += 4;
+    uint32_t block_count = load32_le(input->data + pos);
+    pos += 4;
+
+    if (block_size == 0 || block_count == 0 ||
+        input->size < pos + (size_t)block_count * 4) {
+        LOG_ERROR("Corrupted multiblock header");
+        return GSEA_ERROR_COMPRESSION;
+    }
+
+    block_task_t *tasks = calloc(block_count, sizeof(block_task_t));
+    if (!tasks) {
+        LOG_ERROR("Memory allocation failed for block tasks");
+        return GSEA_ERROR_MEMORY;
+    }
+
+    output->size = 0;
+    if (buffer_reserve(output, orig_size ? orig_size : 1) != GSEA_SUCCESS) {
+        free(tasks);
+        return GSEA_ERROR_MEMORY;
+    }
+
+    /* Tabla de tamaños comprimidos */
+    size_t data_pos = pos + (size_t)block_count * 4;
+    int result = GSEA_SUCCESS;
+
+    for (uint32_t i = 0; i < block_count; i++) {
+        uint32_t comp_size = load32_le(input->data + pos + (size_t)i * 4);
+        size_t dest_offset = (size_t)i * block_size;
+
+        if (data_pos + comp_size > input->size || dest_offset > orig_size) {
+            LOG_ERROR("Corrupted multiblock stream at block %u", i);
+            result = GSEA_ERROR_COMPRESSION;
+            break;
+        }
+
+        tasks[i].input.data = input->data + data_pos;
+        tasks[i].input.size = comp_size;
+        tasks[i].input.capacity = comp_size;
+        tasks[i].algorithm = algorithm;
+        tasks[i].dest = output->data + dest_offset;
+        tasks[i].dest_capacity = MIN(block_size, orig_size - dest_offset);
+        tasks[i].result = GSEA_ERROR_COMPRESSION;
+        data_pos += comp_size;
+
+        if (!pool ||
+            thread_pool_add_task(pool, decompress_block_worker, &tasks[i]) != GSEA_SUCCESS) {
+            decompress_block_worker(&tasks[i]);
+        }
+    }
+
+    if (pool) {
+        thread_pool_wait(pool);
+    }
+
+    if (result == GSEA_SUCCESS) {
+        for (uint32_t i = 0; i < block_count; i++) {
+            if (tasks[i].result != GSEA_SUCCESS) {
+                LOG_ERROR("Block %u decompression failed", i);
+                result = GSEA_ERROR_COMPRESSION;
+                break;
+            }
+        }
+    }
+
+    free(tasks);
+
+    if (result != GSEA_SUCCESS) {
+        free(output->data);
+        output->data = NULL;
+        return result;
+    }
+
+    output->size = orig_size;
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Descomprime solo los bloques que cubren un rango sin comprimir
+ * @details La tabla de tamaños del header GSEAMB01 actúa como índice de
+ *          chunks: el offset sin comprimir i*block_size corresponde al
+ *          bloque i, y la suma de prefijos de la tabla da su posición
+ *          comprimida. Solo se decodifican los bloques tocados por el
+ *          rango, no el stream completo.
+ */
+int decompress_range_parallel(const file_buffer_t *input, file_buffer_t *output,
+                              compression_algorithm_t algorithm,
+                              uint64_t range_offset, uint64_t range_length,
+                              thread_pool_t *pool) {
+    if (!input || !output || range_length == 0) {
+        LOG_ERROR("Invalid parameters for decompress_range_parallel");
+        return GSEA_ERROR_ARGS;
+    }
+
+    /* Envoltorio auto: el algoritmo real viene en el header */
+    file_buffer_t view;
+    if (unwrap_auto(input, &view, &algorithm)) {
+        return decompress_range_parallel(&view, output, algorithm,
+                                         range_offset, range_length, pool);
+    }
+
+    /* Formato store: el payload crudo ya es de acceso aleatorio */
+    if (is_store(input)) {
+        size_t payload = input->size - STORE_HEADER_SIZE;
+        if (range_offset >= payload ||
+            range_length > payload - range_offset) {
+            LOG_ERROR("Range out of bounds (original size %zu)", payload);
+            return GSEA_ERROR_ARGS;
+        }
+        output->size = 0;
+        if (buffer_reserve(output, range_length) != GSEA_SUCCESS) {
+            return GSEA_ERROR_MEMORY;
+        }
+        memcpy(output->data,
+               input->data + STORE_HEADER_SIZE + range_offset, range_length);
+        output->size = range_length;
+        return GSEA_SUCCESS;
+    }
+
+    if (input->size < 24 || memcmp(input->data, MULTIBLOCK_MAGIC, 8) != 0) {
+        LOG_ERROR("Range extraction requires the multiblock format (GSEAMB01)");
+        return GSEA_ERROR_COMPRESSION;
+    }
+
+    /* Parsear header (mismo layout que decompress_data_parallel) */
+    size_t pos = 8;
+    uint64_t orig_size = 0;
+    for (int b = 0; b < 8; b++) {
+        orig_size |= ((uint64_t)input->data[pos++]) << (b * 8);
+    }
+    uint32_t block_size = load32_le(input->data + pos);
+    pos += 4;
+    uint32_t block_count = load32_le(input->data + pos);
+    pos += 4;
+
+    if (block_size == 0 || block_count == 0 ||
+        input->size < pos + (size_t)block_count * 4) {
+        LOG_ERROR("Corrupted multiblock header");
+        return GSEA_ERROR_COMPRESSION;
+    }
+
+    if (range_offset >= orig_size || range_length > orig_size - range_offset) {
+        LOG_ERROR("Range %llu:%llu out of bounds (original size %llu)",
+                  (unsigned long long)range_offset,
+                  (unsigned long long)range_length,
+                  (unsigned long long)orig_size);
+        return GSEA_ERROR_ARGS;
+    }
+
+    /* Bloques tocados por el rango */
+    uint32_t first_block = (uint32_t)(range_offset / block_size);
+    uint32_t last_block = (uint32_t)((range_offset + range_length - 1) / block_size);
+    uint32_t needed = last_block - first_block + 1;
+
+    LOG_INFO("Range extraction: blocks %u-%u of %u (%u decoded)",
+             first_block, last_block, block_count - 1, needed);
+
+    /* Suma de prefijos de la tabla para ubicar el primer bloque necesario */
+    size_t data_pos = pos + (size_t)block_count * 4;
+    for (uint32_t i = 0; i < first_block; i++) {
+        data_pos += load32_le(input->data + pos + (size_t)i * 4);
+    }
+
+    /* Región decodificada: bloques completos que cubren el rango */
+    uint64_t region_start = (uint64_t)first_block * block_size;
+    uint64_t region_size = MIN((uint64_t)needed * block_size,
+                               orig_size - region_start);
+    uint8_t *region = malloc(region_size);
+    block_task_t *tasks = calloc(needed, sizeof(block_task_t));
+    if (!region || !tasks) {
+        LOG_ERROR("Memory allocation failed for range extraction");
+        free(region);
+        free(tasks);
+        return GSEA_ERROR_MEMORY;
+    }
+
+    int result = GSEA_SUCCESS;
+    for (uint32_t i = 0; i < needed; i++) {
+        uint32_t comp_size =
+            load32_le(input->data + pos + (size_t)(first_block + i) * 4);
+        uint64_t dest_offset = (uint64_t)i * block_size;
+
+        if (data_pos + comp_size > input->size) {
+            LOG_ERROR("Corrupted multiblock stream at block %u", first_block + i);
+            result = GSEA_ERROR_COMPRESSION;
+            break;
+        }
+
+        tasks[i].input.data = input->data + data_pos;
+        tasks[i].input.size = comp_size;
+        tasks[i].input.capacity = comp_size;
+        tasks[i].algorithm = algorithm;
+        tasks[i].dest = region + dest_offset;
+        tasks[i].dest_capacity = MIN((uint64_t)block_size,
+                                     region_size - dest_offset);
+        tasks[i].result = GSEA_ERROR_COMPRESSION;
+        data_pos += comp_size;
+
+        if (!pool ||
+            thread_pool_add_task(pool, decompress_block_worker, &tasks[i]) != GSEA_SUCCESS) {
+            decompress_block_worker(&tasks[i]);
+        }
+    }
+
+    if (pool) {
+        thread_pool_wait(pool);
+    }
+
+    if (result == GSEA_SUCCESS) {
+        for (uint32_t i = 0; i < needed; i++) {
+            if (tasks[i].result != GSEA_SUCCESS) {
+                LOG_ERROR("Block %u decompression failed", first_block + i);
+                result = GSEA_ERROR_COMPRESSION;
+                break;
+            }
+        }
+    }
+
+    free(tasks);
+
+    if (result != GSEA_SUCCESS) {
+        free(region);
+        return result;
+    }
+
+    /* Recortar el rango pedido dentro de la región decodificada */
+    if (buffer_reserve(output, range_length) != GSEA_SUCCESS) {
+        free(region);
+        return GSEA_ERROR_MEMORY;
+    }
+    memcpy(output->data, region + (range_offset - region_start), range_length);
+    output->size = range_length;
+
+    free(region);
+    return GSEA_SUCCESS;
 }
 
 /**
@@ -130,100 +779,52 @@ int decompress_data(const file_buffer_t *input, file_buffer_t *output,
         LOG_ERROR("Invalid parameters for decompress_data");
         return GSEA_ERROR_ARGS;
     }
-    
+
+    /* Envoltorio auto: el algoritmo real viene en el header */
+    file_buffer_t view;
+    if (unwrap_auto(input, &view, &algorithm)) {
+        return decompress_data(&view, output, algorithm);
+    }
+
+    /* Formato store (autodescriptivo): puede aparecer con cualquier
+       --comp-alg por el guardián de expansión */
+    if (is_store(input)) {
+        return unstore_raw(input, output);
+    }
+
     switch (algorithm) {
         case COMP_LZ77:
             return lz77_decompress(input, output);
-            
+
         case COMP_HUFFMAN: {
-            /* Deserializar desde file_buffer_t */
-            huffman_compressed_t *compressed = NULL;
-            int result = huffman_deserialize(input->data, input->size, &compressed);
-            
-            if (result != HUFFMAN_SUCCESS) {
-                LOG_ERROR("Huffman deserialization failed: %d", result);
-                return GSEA_ERROR_COMPRESSION;
-            }
-            
-            /* Descomprimir */
-            uint8_t *decompressed = NULL;
-            size_t decompressed_size = 0;
-            result = huffman_decompress(compressed, &decompressed, &decompressed_size);
-            
+            /* Ruta directa: decodifica desde el buffer serializado (los
+               archivos legacy caen internamente en la ruta clásica) */
+            int result = huffman_decode(input, output);
             if (result != HUFFMAN_SUCCESS) {
-                huffman_free_compressed(compressed);
                 LOG_ERROR("Huffman decompression failed: %d", result);
                 return GSEA_ERROR_COMPRESSION;
             }
-            
-            /* Copiar al buffer de salida */
-            output->data = decompressed;
-            output->size = decompressed_size;
-            output->capacity = decompressed_size;
-            
-            huffman_free_compressed(compressed);
             return GSEA_SUCCESS;
         }
-            
+
         case COMP_RLE: {
-            /* Deserializar desde file_buffer_t */
-            rle_compressed_t *compressed = NULL;
-            int result = rle_deserialize(input->data, input->size, &compressed);
-            
+            int result = rle_decode(input, output);
             if (result != RLE_SUCCESS) {
-                LOG_ERROR("RLE deserialization failed: %d", result);
-                return GSEA_ERROR_COMPRESSION;
-            }
-            
-            /* Descomprimir */
-            uint8_t *decompressed = NULL;
-            size_t decompressed_size = 0;
-            result = rle_decompress(compressed, &decompressed, &decompressed_size);
-            
-            if (result != RLE_SUCCESS) {
-                rle_free_compressed(compressed);
                 LOG_ERROR("RLE decompression failed: %d", result);
                 return GSEA_ERROR_COMPRESSION;
             }
-            
-            /* Copiar al buffer de salida */
-            output->data = decompressed;
-            output->size = decompressed_size;
-            output->capacity = decompressed_size;
-            
-            rle_free_compressed(compressed);
             return GSEA_SUCCESS;
         }
+
         case COMP_LZW: {
-            /* Deserializar desde file_buffer_t */
-            lzw_compressed_t *compressed = NULL;
-            int result = lzw_deserialize(input->data, input->size, &compressed);
-            
+            int result = lzw_decode(input, output);
             if (result != LZW_SUCCESS) {
-                LOG_ERROR("LZW deserialization failed: %d", result);
-                return GSEA_ERROR_COMPRESSION;
-            }
-            
-            /* Descomprimir */
-            uint8_t *decompressed = NULL;
-            size_t decompressed_size = 0;
-            result = lzw_decompress(compressed, &decompressed, &decompressed_size);
-            
-            if (result != LZW_SUCCESS) {
-                lzw_free_compressed(compressed);
                 LOG_ERROR("LZW decompression failed: %d", result);
                 return GSEA_ERROR_COMPRESSION;
             }
-            
-            /* Copiar al buffer de salida */
-            output->data = decompressed;
-            output->size = decompressed_size;
-            output->capacity = decompressed_size;
-            
-            lzw_free_compressed(compressed);
             return GSEA_SUCCESS;
         }
-            
+
         default:
             LOG_ERROR("Unknown compression algorithm: %d", algorithm);
             return GSEA_ERROR_ARGS;
@@ -8,6 +8,13 @@
 #define COMPRESSION_H
 
 #include "../common.h"
+#include "../concurrency/thread_pool.h"
+
+/* Tamaño de bloque para compresión paralela intra-archivo (1 MB) */
+#define COMP_BLOCK_SIZE (1u * 1024u * 1024u)
+
+/* Umbral mínimo para dividir en bloques (evita overhead en archivos chicos) */
+#define COMP_PARALLEL_THRESHOLD (2u * COMP_BLOCK_SIZE)
 
 /**
  * @brief Comprime datos usando el algoritmo especificado
@@ -29,4 +36,48 @@ int compress_data(const file_buffer_t *input, file_buffer_t *output,
 int decompress_data(const file_buffer_t *input, file_buffer_t *output,
                     compression_algorithm_t algorithm);
 
+/**
+ * @brief Comprime dividiendo la entrada en bloques independientes en paralelo
+ * @details Emite un formato multi-bloque enmarcado (magic GSEAMB01 + tabla de
+ *          tamaños comprimidos). Si la entrada es pequeña o pool es NULL,
+ *          delega en compress_data() con el formato monolítico clásico.
+ * @param input Buffer de entrada con datos sin comprimir
+ * @param output Buffer de salida para datos comprimidos
+ * @param algorithm Algoritmo de compresión a utilizar
+ * @param pool Pool de hilos para los bloques (puede ser NULL)
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int compress_data_parallel(const file_buffer_t *input, file_buffer_t *output,
+                           compression_algorithm_t algorithm, thread_pool_t *pool);
+
+/**
+ * @brief Descomprime un stream multi-bloque en paralelo
+ * @details Detecta el magic GSEAMB01; si no está presente asume el formato
+ *          monolítico y delega en decompress_data().
+ * @param input Buffer de entrada con datos comprimidos
+ * @param output Buffer de salida para datos descomprimidos
+ * @param algorithm Algoritmo de descompresión a utilizar
+ * @param pool Pool de hilos para los bloques (puede ser NULL)
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int decompress_data_parallel(const file_buffer_t *input, file_buffer_t *output,
+                             compression_algorithm_t algorithm, thread_pool_t *pool);
+
+/**
+ * @brief Extrae un rango sin comprimir decodificando solo sus bloques
+ * @details Usa la tabla de tamaños del formato GSEAMB01 como índice de
+ *          chunks para el acceso aleatorio. Requiere formato multi-bloque.
+ * @param input Buffer comprimido en formato multi-bloque
+ * @param output Buffer de salida con exactamente range_length bytes
+ * @param algorithm Algoritmo de descompresión de los bloques
+ * @param range_offset Offset del rango en los datos sin comprimir
+ * @param range_length Longitud del rango (mayor que cero)
+ * @param pool Pool de hilos para los bloques (puede ser NULL)
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int decompress_range_parallel(const file_buffer_t *input, file_buffer_t *output,
+                              compression_algorithm_t algorithm,
+                              uint64_t range_offset, uint64_t range_length,
+                              thread_pool_t *pool);
+
 #endif /* COMPRESSION_H */
@@ -4,6 +4,7 @@
  */
 
 #include "huffman.h"
+#include "../utils/buffer_pool.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -16,12 +17,6 @@ typedef struct huffman_node {
     struct huffman_node *right;
 } huffman_node_t;
 
-/* Estructura para códigos Huffman */
-typedef struct {
-    uint8_t bits[HUFFMAN_MAX_CODE_LENGTH];
-    int length;
-} huffman_code_t;
-
 /* Cola de prioridad mínima para construcción del árbol */
 typedef struct {
     huffman_node_t **nodes;
@@ -160,29 +155,192 @@ static huffman_node_t *build_huffman_tree(const uint32_t freq[HUFFMAN_SYMBOLS])
     return root;
 }
 
-/* Genera códigos Huffman desde el árbol */
-static void generate_codes(huffman_node_t *root, huffman_code_t codes[HUFFMAN_SYMBOLS], 
-                          uint8_t code[], int depth) {
+/* ==================== CÓDIGOS CANÓNICOS ==================== */
+/* Solo importan las longitudes del árbol: los valores se reasignan de
+   forma canónica (por longitud y símbolo), así el decodificador puede
+   reconstruirlos a partir de 256 bytes en lugar del árbol completo.
+   Con frecuencias de 32 bits la profundidad máxima real es < 64, por lo
+   que un uint64_t siempre puede contener el código */
+
+/**
+ * @brief Extrae la longitud de código de cada hoja del árbol
+ */
+static void collect_code_lengths(const huffman_node_t *root,
+                                 uint8_t lengths[HUFFMAN_SYMBOLS], int depth) {
     if (!root) return;
-    
-    /* Nodo hoja */
     if (!root->left && !root->right) {
-        codes[root->symbol].length = depth;
-        memcpy(codes[root->symbol].bits, code, depth);
+        lengths[root->symbol] = (uint8_t)depth;
         return;
     }
-    
-    /* Recorrer izquierda (bit 0) */
-    if (root->left) {
-        code[depth] = 0;
-        generate_codes(root->left, codes, code, depth + 1);
+    collect_code_lengths(root->left, lengths, depth + 1);
+    collect_code_lengths(root->right, lengths, depth + 1);
+}
+
+/**
+ * @brief Asigna valores canónicos a partir de las longitudes
+ * @return Longitud máxima de código encontrada
+ */
+static int assign_canonical_codes(const uint8_t lengths[HUFFMAN_SYMBOLS],
+                                  uint64_t code_values[HUFFMAN_SYMBOLS]) {
+    uint32_t bl_count[HUFFMAN_MAX_CODE_LENGTH + 1] = {0};
+    uint64_t next_code[HUFFMAN_MAX_CODE_LENGTH + 1] = {0};
+    int max_len = 0;
+
+    for (int i = 0; i < HUFFMAN_SYMBOLS; i++) {
+        bl_count[lengths[i]]++;
+        if (lengths[i] > max_len) max_len = lengths[i];
     }
-    
-    /* Recorrer derecha (bit 1) */
-    if (root->right) {
-        code[depth] = 1;
-        generate_codes(root->right, codes, code, depth + 1);
+    bl_count[0] = 0;
+
+    uint64_t code = 0;
+    for (int len = 1; len <= max_len; len++) {
+        code = (code + bl_count[len - 1]) << 1;
+        next_code[len] = code;
+    }
+
+    for (int i = 0; i < HUFFMAN_SYMBOLS; i++) {
+        if (lengths[i] > 0) {
+            code_values[i] = next_code[lengths[i]]++;
+        }
     }
+
+    return max_len;
+}
+
+/* ==================== DECODIFICADOR POR TABLA ==================== */
+/* Tabla primaria de HUFFMAN_LUT_BITS bits: los códigos cortos se
+   resuelven con una sola lectura; entrada 0 = escape a la ruta lenta
+   por longitudes (códigos largos o patrones inválidos) */
+typedef struct {
+    uint16_t lut[1u << HUFFMAN_LUT_BITS];  /* (símbolo << 8) | longitud */
+    uint64_t first_code[HUFFMAN_MAX_CODE_LENGTH + 1];
+    uint32_t count[HUFFMAN_MAX_CODE_LENGTH + 1];
+    uint32_t offset[HUFFMAN_MAX_CODE_LENGTH + 1];
+    uint8_t sorted_symbols[HUFFMAN_SYMBOLS];
+    int max_len;
+} huffman_decoder_t;
+
+/**
+ * @brief Construye las tablas de decodificación canónica
+ */
+static int build_decoder(const uint8_t lengths[HUFFMAN_SYMBOLS],
+                         huffman_decoder_t *dec) {
+    uint64_t code_values[HUFFMAN_SYMBOLS] = {0};
+
+    memset(dec, 0, sizeof(*dec));
+    dec->max_len = assign_canonical_codes(lengths, code_values);
+    if (dec->max_len == 0) {
+        return HUFFMAN_ERROR_CORRUPT;
+    }
+
+    for (int i = 0; i < HUFFMAN_SYMBOLS; i++) {
+        dec->count[lengths[i]]++;
+    }
+    dec->count[0] = 0;
+
+    /* Offsets de cada longitud en sorted_symbols y primer código */
+    uint32_t running = 0;
+    uint64_t code = 0;
+    for (int len = 1; len <= dec->max_len; len++) {
+        code = (code + dec->count[len - 1]) << 1;
+        dec->first_code[len] = code;
+        dec->offset[len] = running;
+        running += dec->count[len];
+    }
+
+    /* Símbolos ordenados por (longitud, símbolo): el orden canónico */
+    for (int len = 1, idx = 0; len <= dec->max_len; len++) {
+        for (int i = 0; i < HUFFMAN_SYMBOLS; i++) {
+            if (lengths[i] == len) {
+                dec->sorted_symbols[idx++] = (uint8_t)i;
+            }
+        }
+    }
+
+    /* Tabla primaria */
+    for (int i = 0; i < HUFFMAN_SYMBOLS; i++) {
+        int len = lengths[i];
+        if (len == 0 || len > HUFFMAN_LUT_BITS) continue;
+        uint32_t base = (uint32_t)(code_values[i] << (HUFFMAN_LUT_BITS - len));
+        uint32_t span = 1u << (HUFFMAN_LUT_BITS - len);
+        for (uint32_t j = 0; j < span; j++) {
+            dec->lut[base + j] = (uint16_t)((i << 8) | len);
+        }
+    }
+
+    return HUFFMAN_SUCCESS;
+}
+
+/**
+ * @brief Decodifica un bitstream canónico con la tabla primaria
+ */
+static int decode_canonical(const huffman_decoder_t *dec,
+                            const uint8_t *data, size_t data_size,
+                            uint8_t *output, size_t output_size) {
+    uint64_t bit_buf = 0;
+    int bit_count = 0;
+    size_t byte_pos = 0;
+    size_t out_pos = 0;
+
+    while (out_pos < output_size) {
+        /* Rellenar el buffer de bits (MSB primero) */
+        while (bit_count <= 56 && byte_pos < data_size) {
+            bit_buf = (bit_buf << 8) | data[byte_pos++];
+            bit_count += 8;
+        }
+        if (bit_count == 0) {
+            return HUFFMAN_ERROR_CORRUPT; /* Stream agotado */
+        }
+
+        /* Mirar HUFFMAN_LUT_BITS bits (relleno con ceros al final) */
+        uint32_t peek;
+        if (bit_count >= HUFFMAN_LUT_BITS) {
+            peek = (uint32_t)(bit_buf >> (bit_count - HUFFMAN_LUT_BITS)) &
+                   ((1u << HUFFMAN_LUT_BITS) - 1);
+        } else {
+            peek = (uint32_t)(bit_buf << (HUFFMAN_LUT_BITS - bit_count)) &
+                   ((1u << HUFFMAN_LUT_BITS) - 1);
+        }
+
+        uint16_t entry = dec->lut[peek];
+        int len = entry & 0xFF;
+
+        if (len > 0 && len <= bit_count) {
+            output[out_pos++] = (uint8_t)(entry >> 8);
+            bit_count -= len;
+            continue;
+        }
+
+        /* Ruta lenta: códigos más largos que la tabla primaria */
+        uint64_t code = 0;
+        int code_len = 0;
+        bool found = false;
+        while (code_len < dec->max_len) {
+            if (bit_count == 0) {
+                if (byte_pos >= data_size) break;
+                bit_buf = (bit_buf << 8) | data[byte_pos++];
+                bit_count += 8;
+            }
+            code = (code << 1) | ((bit_buf >> (bit_count - 1)) & 1);
+            bit_count--;
+            code_len++;
+
+            if (dec->count[code_len] > 0 &&
+                code >= dec->first_code[code_len] &&
+                code < dec->first_code[code_len] + dec->count[code_len]) {
+                size_t idx = dec->offset[code_len] +
+                             (size_t)(code - dec->first_code[code_len]);
+                output[out_pos++] = dec->sorted_symbols[idx];
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return HUFFMAN_ERROR_CORRUPT;
+        }
+    }
+
+    return HUFFMAN_SUCCESS;
 }
 
 int huffman_compress(const uint8_t *input, size_t input_size, huffman_compressed_t **output) {
@@ -221,54 +379,62 @@ int huffman_compress(const uint8_t *input, size_t input_size, huffman_compressed
         result->size = 1;
         result->original_size = input_size;
         memcpy(result->freq_table, freq, sizeof(freq));
-        
+        memset(result->code_lengths, 0, sizeof(result->code_lengths));
+        result->canonical = true;
+
         free_tree(root);
         *output = result;
         return HUFFMAN_SUCCESS;
     }
-    
-    /* Generar códigos */
-    huffman_code_t codes[HUFFMAN_SYMBOLS] = {0};
-    uint8_t code_buffer[HUFFMAN_MAX_CODE_LENGTH];
-    generate_codes(root, codes, code_buffer, 0);
+
+    /* Del árbol solo se conservan las longitudes; los valores de código
+       se reasignan de forma canónica */
+    uint8_t lengths[HUFFMAN_SYMBOLS] = {0};
+    collect_code_lengths(root, lengths, 0);
     free_tree(root);
-    
+
+    uint64_t code_values[HUFFMAN_SYMBOLS] = {0};
+    assign_canonical_codes(lengths, code_values);
+
     /* Calcular tamaño de salida en bits */
     size_t total_bits = 0;
     for (size_t i = 0; i < input_size; i++) {
-        total_bits += codes[input[i]].length;
+        total_bits += lengths[input[i]];
     }
-    
+
     size_t output_bytes = (total_bits + 7) / 8;
-    
+
     /* Crear estructura de salida */
     huffman_compressed_t *result = malloc(sizeof(huffman_compressed_t));
     if (!result) {
         return HUFFMAN_ERROR_MEMORY;
     }
-    
+
     result->data = calloc(output_bytes, 1);
     if (!result->data) {
         free(result);
         return HUFFMAN_ERROR_MEMORY;
     }
-    
+
     result->size = output_bytes;
     result->original_size = input_size;
     memcpy(result->freq_table, freq, sizeof(freq));
-    
-    /* Escribir datos comprimidos bit a bit */
+    memcpy(result->code_lengths, lengths, sizeof(result->code_lengths));
+    result->canonical = true;
+
+    /* Escribir datos comprimidos bit a bit (MSB primero) */
     size_t bit_pos = 0;
     for (size_t i = 0; i < input_size; i++) {
-        huffman_code_t *code = &codes[input[i]];
-        for (int j = 0; j < code->length; j++) {
-            if (code->bits[j]) {
+        int len = lengths[input[i]];
+        uint64_t code = code_values[input[i]];
+        for (int j = len - 1; j >= 0; j--) {
+            if ((code >> j) & 1) {
                 result->data[bit_pos / 8] |= (1 << (7 - (bit_pos % 8)));
             }
             bit_pos++;
         }
     }
-    
+
     *output = result;
     return HUFFMAN_SUCCESS;
 }
@@ -277,8 +443,57 @@ int huffman_decompress(const huffman_compressed_t *compressed, uint8_t **output,
     if (!compressed || !output || !output_size) {
         return HUFFMAN_ERROR_INPUT;
     }
-    
-    /* Reconstruir árbol desde frecuencias */
+
+    /* Formato v2: decodificación canónica por tabla */
+    if (compressed->canonical) {
+        uint8_t *result = malloc(compressed->original_size);
+        if (!result) {
+            return HUFFMAN_ERROR_MEMORY;
+        }
+
+        /* Caso especial: un solo símbolo (ninguna longitud asignada) */
+        bool any_code = false;
+        for (int i = 0; i < HUFFMAN_SYMBOLS; i++) {
+            if (compressed->code_lengths[i] > 0) {
+                any_code = true;
+                break;
+            }
+        }
+        if (!any_code) {
+            if (compressed->size < 1) {
+                free(result);
+                return HUFFMAN_ERROR_CORRUPT;
+            }
+            memset(result, compressed->data[0], compressed->original_size);
+            *output = result;
+            *output_size = compressed->original_size;
+            return HUFFMAN_SUCCESS;
+        }
+
+        huffman_decoder_t *dec = malloc(sizeof(huffman_decoder_t));
+        if (!dec) {
+            free(result);
+            return HUFFMAN_ERROR_MEMORY;
+        }
+
+        int status = build_decoder(compressed->code_lengths, dec);
+        if (status == HUFFMAN_SUCCESS) {
+            status = decode_canonical(dec, compressed->data, compressed->size,
+                                      result, compressed->original_size);
+        }
+        free(dec);
+
+        if (status != HUFFMAN_SUCCESS) {
+            free(result);
+            return status;
+        }
+
+        *output = result;
+        *output_size = compressed->original_size;
+        return HUFFMAN_SUCCESS;
+    }
+
+    /* Formato legacy: reconstruir árbol desde frecuencias */
     huffman_node_t *root = build_huffman_tree(compressed->freq_table);
     if (!root) {
         return HUFFMAN_ERROR_MEMORY;
@@ -347,7 +562,33 @@ int huffman_serialize(const huffman_compressed_t *compressed, uint8_t **output,
         return HUFFMAN_ERROR_INPUT;
     }
     
-    /* Formato: [original_size:8][compressed_size:8][freq_table:256*4][data] */
+    /* Formato v2 (canónico): [magic "HUF2":4][original_size:8]
+       [compressed_size:8][code_lengths:256][data] — 276 bytes de header
+       frente a los 1040 del formato legacy */
+    if (compressed->canonical) {
+        size_t total_size = 4 + 16 + HUFFMAN_SYMBOLS + compressed->size;
+        uint8_t *buffer = malloc(total_size);
+        if (!buffer) {
+            return HUFFMAN_ERROR_MEMORY;
+        }
+
+        size_t pos = 0;
+        memcpy(buffer + pos, "HUF2", 4);
+        pos += 4;
+        memcpy(buffer + pos, &compressed->original_size, 8);
+        pos += 8;
+        memcpy(buffer + pos, &compressed->size, 8);
+        pos += 8;
+        memcpy(buffer + pos, compressed->code_lengths, HUFFMAN_SYMBOLS);
+        pos += HUFFMAN_SYMBOLS;
+        memcpy(buffer + pos, compressed->data, compressed->size);
+
+        *output = buffer;
+        *output_size = total_size;
+        return HUFFMAN_SUCCESS;
+    }
+
+    /* Formato legacy: [original_size:8][compressed_size:8][freq_table:256*4][data] */
     size_t total_size = 16 + (HUFFMAN_SYMBOLS * 4) + compressed->size;
     uint8_t *buffer = malloc(total_size);
     if (!buffer) {
@@ -381,18 +622,53 @@ int huffman_deserialize(const uint8_t *input, size_t input_size, huffman_compres
         return HUFFMAN_ERROR_INPUT;
     }
     
+    /* Detectar formato v2 por magic y tamaño coherente */
+    size_t v2_header = 4 + 16 + HUFFMAN_SYMBOLS;
+    if (input_size >= v2_header && memcmp(input, "HUF2", 4) == 0) {
+        huffman_compressed_t *result = malloc(sizeof(huffman_compressed_t));
+        if (!result) {
+            return HUFFMAN_ERROR_MEMORY;
+        }
+
+        size_t pos = 4;
+        memcpy(&result->original_size, input + pos, 8);
+        pos += 8;
+        memcpy(&result->size, input + pos, 8);
+        pos += 8;
+        memcpy(result->code_lengths, input + pos, HUFFMAN_SYMBOLS);
+        pos += HUFFMAN_SYMBOLS;
+
+        if (input_size != pos + result->size) {
+            free(result);
+            return HUFFMAN_ERROR_CORRUPT;
+        }
+
+        result->data = malloc(result->size);
+        if (!result->data) {
+            free(result);
+            return HUFFMAN_ERROR_MEMORY;
+        }
+        memcpy(result->data, input + pos, result->size);
+
+        memset(result->freq_table, 0, sizeof(result->freq_table));
+        result->canonical = true;
+
+        *compressed = result;
+        return HUFFMAN_SUCCESS;
+    }
+
     size_t min_size = 16 + (HUFFMAN_SYMBOLS * 4);
     if (input_size < min_size) {
         return HUFFMAN_ERROR_CORRUPT;
     }
-    
+
     huffman_compressed_t *result = malloc(sizeof(huffman_compressed_t));
     if (!result) {
         return HUFFMAN_ERROR_MEMORY;
     }
-    
+
     size_t pos = 0;
-    
+
     /* Leer tamaño original */
     memcpy(&result->original_size, input + pos, 8);
     pos += 8;
@@ -419,7 +695,329 @@ int huffman_deserialize(const uint8_t *input, size_t input_size, huffman_compres
     }
     
     memcpy(result->data, input + pos, result->size);
-    
+
+    memset(result->code_lengths, 0, sizeof(result->code_lengths));
+    result->canonical = false;
+
     *compressed = result;
     return HUFFMAN_SUCCESS;
+}
+
+/* ==================== RUTA DIRECTA (SIN COPIA INTERMEDIA) ==================== */
+/* Escriben/leen el formato v2 directamente sobre file_buffer_t: header y
+   bitstream van a una única asignación, sin huffman_compressed_t de por
+   medio. Los archivos legacy caen en la ruta de deserialización clásica */
+
+#define HUFFMAN_V2_HEADER (4 + 16 + HUFFMAN_SYMBOLS)
+
+int huffman_encode(const file_buffer_t *input, file_buffer_t *output) {
+    if (!input || !output || !input->data || input->size == 0) {
+        return HUFFMAN_ERROR_INPUT;
+    }
+
+    uint32_t freq[HUFFMAN_SYMBOLS] = {0};
+    for (size_t i = 0; i < input->size; i++) {
+        freq[input->data[i]]++;
+    }
+
+    huffman_node_t *root = build_huffman_tree(freq);
+    if (!root) {
+        return HUFFMAN_ERROR_MEMORY;
+    }
+
+    uint8_t lengths[HUFFMAN_SYMBOLS] = {0};
+    uint64_t code_values[HUFFMAN_SYMBOLS] = {0};
+    size_t payload_bytes;
+
+    if (!root->left && !root->right) {
+        /* Un solo símbolo: sin longitudes, el dato es el propio símbolo */
+        payload_bytes = 1;
+        lengths[root->symbol] = 0;
+    } else {
+        collect_code_lengths(root, lengths, 0);
+        assign_canonical_codes(lengths, code_values);
+
+        size_t total_bits = 0;
+        for (size_t i = 0; i < input->size; i++) {
+            total_bits += lengths[input->data[i]];
+        }
+        payload_bytes = (total_bits + 7) / 8;
+    }
+
+    uint8_t symbol = root->symbol;
+    bool single = (!root->left && !root->right);
+    free_tree(root);
+
+    if (buffer_reserve(output, HUFFMAN_V2_HEADER + payload_bytes)
+            != GSEA_SUCCESS) {
+        return HUFFMAN_ERROR_MEMORY;
+    }
+    memset(output->data, 0, HUFFMAN_V2_HEADER + payload_bytes);
+
+    /* Header: [magic "HUF2":4][original_size:8][compressed_size:8][lengths:256] */
+    memcpy(output->data, "HUF2", 4);
+    memcpy(output->data + 4, &input->size, 8);
+    memcpy(output->data + 12, &payload_bytes, 8);
+    memcpy(output->data + 20, lengths, HUFFMAN_SYMBOLS);
+
+    uint8_t *payload = output->data + HUFFMAN_V2_HEADER;
+    if (single) {
+        payload[0] = symbol;
+    } else {
+        size_t bit_pos = 0;
+        for (size_t i = 0; i < input->size; i++) {
+            int len = lengths[input->data[i]];
+            uint64_t code = code_values[input->data[i]];
+            for (int j = len - 1; j >= 0; j--) {
+                if ((code >> j) & 1) {
+                    payload[bit_pos / 8] |= (1 << (7 - (bit_pos % 8)));
+                }
+                bit_pos++;
+            }
+        }
+    }
+
+    output->size = HUFFMAN_V2_HEADER + payload_bytes;
+    return HUFFMAN_SUCCESS;
+}
+
+/* ==================== CODIFICACIÓN EN PARALELO ==================== */
+/* Ambas fases del encoder son paralelizables por porciones: el histograma
+   se fusiona al final (256 sumas) y la emisión de bits arranca en el offset
+   exacto de cada porción, calculable por prefix-sum de los histogramas
+   parciales sin una pasada extra sobre los datos */
+
+/* Tamaño de porción y límites del reparto */
+#define HUFFMAN_PARALLEL_SLICE (1u * 1024u * 1024u)
+#define HUFFMAN_MAX_SLICES 32
+
+typedef struct {
+    const uint8_t *data;            /* Vista sobre la porción */
+    size_t size;
+    uint32_t freq[HUFFMAN_SYMBOLS]; /* Histograma parcial (fase 1) */
+    const uint8_t *lengths;         /* Tabla compartida (fase 2) */
+    const uint64_t *code_values;
+    uint8_t *payload;               /* Bitstream de salida compartido */
+    size_t bit_offset;              /* Primer bit de esta porción */
+    uint8_t head_byte;              /* Bits del byte compartido con la
+                                       porción anterior (se fusiona luego) */
+} huffman_slice_t;
+
+static void histogram_worker(void *arg) {
+    huffman_slice_t *slice = (huffman_slice_t *)arg;
+    for (size_t i = 0; i < slice->size; i++) {
+        slice->freq[slice->data[i]]++;
+    }
+}
+
+static void encode_slice_worker(void *arg) {
+    huffman_slice_t *slice = (huffman_slice_t *)arg;
+    size_t bit_pos = slice->bit_offset;
+
+    /* Si la porción no arranca alineada, su primer byte lo comparte con la
+       porción anterior: esos bits van a head_byte y se fusionan al final
+       para que cada byte del payload tenga un único escritor */
+    size_t shared_byte = (bit_pos % 8) ? bit_pos / 8 : (size_t)-1;
+    slice->head_byte = 0;
+
+    for (size_t i = 0; i < slice->size; i++) {
+        int len = slice->lengths[slice->data[i]];
+        uint64_t code = slice->code_values[slice->data[i]];
+        for (int j = len - 1; j >= 0; j--) {
+            if ((code >> j) & 1) {
+                uint8_t bit = (uint8_t)(1u << (7 - (bit_pos % 8)));
+                if (bit_pos / 8 == shared_byte) {
+                    slice->head_byte |= bit;
+                } else {
+                    slice->payload[bit_pos / 8] |= bit;
+                }
+            }
+            bit_pos++;
+        }
+    }
+}
+
+int huffman_encode_parallel(const file_buffer_t *input, file_buffer_t *output,
+                            thread_pool_t *pool) {
+    if (!input || !output || !input->data || input->size == 0) {
+        return HUFFMAN_ERROR_INPUT;
+    }
+
+    /* Entradas chicas o sin pool: la ruta serial es más barata */
+    size_t slice_count = input->size / HUFFMAN_PARALLEL_SLICE;
+    if (!pool || slice_count < 2) {
+        return huffman_encode(input, output);
+    }
+    slice_count = MIN(slice_count, HUFFMAN_MAX_SLICES);
+
+    huffman_slice_t *slices = calloc(slice_count, sizeof(huffman_slice_t));
+    if (!slices) {
+        return HUFFMAN_ERROR_MEMORY;
+    }
+
+    /* Fase 1: histogramas parciales en paralelo */
+    size_t slice_size = input->size / slice_count;
+    for (size_t i = 0; i < slice_count; i++) {
+        slices[i].data = input->data + i * slice_size;
+        slices[i].size = (i == slice_count - 1)
+                             ? input->size - i * slice_size
+                             : slice_size;
+        if (thread_pool_add_task(pool, histogram_worker, &slices[i])
+                != GSEA_SUCCESS) {
+            histogram_worker(&slices[i]);
+        }
+    }
+    thread_pool_wait(pool);
+
+    uint32_t freq[HUFFMAN_SYMBOLS] = {0};
+    for (size_t i = 0; i < slice_count; i++) {
+        for (int s = 0; s < HUFFMAN_SYMBOLS; s++) {
+            freq[s] += slices[i].freq[s];
+        }
+    }
+
+    /* Árbol y códigos canónicos compartidos (serial: 256 símbolos) */
+    huffman_node_t *root = build_huffman_tree(freq);
+    if (!root) {
+        free(slices);
+        return HUFFMAN_ERROR_MEMORY;
+    }
+    if (!root->left && !root->right) {
+        /* Un solo símbolo: caso trivial, resolver por la ruta serial */
+        free_tree(root);
+        free(slices);
+        return huffman_encode(input, output);
+    }
+
+    uint8_t lengths[HUFFMAN_SYMBOLS] = {0};
+    uint64_t code_values[HUFFMAN_SYMBOLS] = {0};
+    collect_code_lengths(root, lengths, 0);
+    assign_canonical_codes(lengths, code_values);
+    free_tree(root);
+
+    /* Offsets de bit por prefix-sum: los bits de cada porción se conocen
+       por su histograma, sin releer los datos */
+    size_t total_bits = 0;
+    for (size_t i = 0; i < slice_count; i++) {
+        slices[i].bit_offset = total_bits;
+        for (int s = 0; s < HUFFMAN_SYMBOLS; s++) {
+            total_bits += (size_t)slices[i].freq[s] * lengths[s];
+        }
+    }
+    size_t payload_bytes = (total_bits + 7) / 8;
+
+    if (buffer_reserve(output, HUFFMAN_V2_HEADER + payload_bytes)
+            != GSEA_SUCCESS) {
+        free(slices);
+        return HUFFMAN_ERROR_MEMORY;
+    }
+    memset(output->data, 0, HUFFMAN_V2_HEADER + payload_bytes);
+
+    memcpy(output->data, "HUF2", 4);
+    memcpy(output->data + 4, &input->size, 8);
+    memcpy(output->data + 12, &payload_bytes, 8);
+    memcpy(output->data + 20, lengths, HUFFMAN_SYMBOLS);
+
+    /* Fase 2: emisión de bits en paralelo, cada porción en su offset */
+    uint8_t *payload = output->data + HUFFMAN_V2_HEADER;
+    for (size_t i = 0; i < slice_count; i++) {
+        slices[i].lengths = lengths;
+        slices[i].code_values = code_values;
+        slices[i].payload = payload;
+        if (thread_pool_add_task(pool, encode_slice_worker, &slices[i])
+                != GSEA_SUCCESS) {
+            encode_slice_worker(&slices[i]);
+        }
+    }
+    thread_pool_wait(pool);
+
+    /* Fusionar los bytes frontera compartidos entre porciones vecinas */
+    for (size_t i = 0; i < slice_count; i++) {
+        if (slices[i].bit_offset % 8) {
+            payload[slices[i].bit_offset / 8] |= slices[i].head_byte;
+        }
+    }
+
+    free(slices);
+    output->size = HUFFMAN_V2_HEADER + payload_bytes;
+    return HUFFMAN_SUCCESS;
+}
+
+int huffman_decode(const file_buffer_t *input, file_buffer_t *output) {
+    if (!input || !output || !input->data) {
+        return HUFFMAN_ERROR_INPUT;
+    }
+
+    /* Formato legacy: pasar por la ruta clásica con estructura intermedia */
+    if (input->size < HUFFMAN_V2_HEADER || memcmp(input->data, "HUF2", 4) != 0) {
+        huffman_compressed_t *compressed = NULL;
+        int result = huffman_deserialize(input->data, input->size, &compressed);
+        if (result != HUFFMAN_SUCCESS) {
+            return result;
+        }
+        uint8_t *decompressed = NULL;
+        size_t decompressed_size = 0;
+        result = huffman_decompress(compressed, &decompressed, &decompressed_size);
+        huffman_free_compressed(compressed);
+        if (result != HUFFMAN_SUCCESS) {
+            return result;
+        }
+        free(output->data);    /* Soltar almacenamiento previo (pool) */
+        output->data = decompressed;
+        output->size = decompressed_size;
+        output->capacity = decompressed_size;
+        return HUFFMAN_SUCCESS;
+    }
+
+    /* Formato v2: decodificar en el sitio, sin copiar header ni payload */
+    size_t original_size, payload_bytes;
+    memcpy(&original_size, input->data + 4, 8);
+    memcpy(&payload_bytes, input->data + 12, 8);
+    const uint8_t *lengths = input->data + 20;
+    const uint8_t *payload = input->data + HUFFMAN_V2_HEADER;
+
+    if (input->size != HUFFMAN_V2_HEADER + payload_bytes || payload_bytes == 0) {
+        return HUFFMAN_ERROR_CORRUPT;
+    }
+
+    uint8_t *result = malloc(original_size ? original_size : 1);
+    if (!result) {
+        return HUFFMAN_ERROR_MEMORY;
+    }
+
+    bool any_code = false;
+    for (int i = 0; i < HUFFMAN_SYMBOLS; i++) {
+        if (lengths[i] > 0) {
+            any_code = true;
+            break;
+        }
+    }
+
+    int status = HUFFMAN_SUCCESS;
+    if (!any_code) {
+        memset(result, payload[0], original_size);
+    } else {
+        huffman_decoder_t *dec = malloc(sizeof(huffman_decoder_t));
+        if (!dec) {
+            free(result);
+            return HUFFMAN_ERROR_MEMORY;
+        }
+        status = build_decoder(lengths, dec);
+        if (status == HUFFMAN_SUCCESS) {
+            status = decode_canonical(dec, payload, payload_bytes,
+                                      result, original_size);
+        }
+        free(dec);
+    }
+
+    if (status != HUFFMAN_SUCCESS) {
+        free(result);
+        return status;
+    }
+
+    free(output->data);    /* Soltar almacenamiento previo (pool) */
+    output->data = result;
+    output->size = original_size;
+    output->capacity = original_size;
+    return HUFFMAN_SUCCESS;
 }
\ No newline at end of file
@@ -7,8 +7,11 @@
 #ifndef HUFFMAN_H
 #define HUFFMAN_H
 
+#include "../common.h"
+#include "../concurrency/thread_pool.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
 
 /* Códigos de retorno */
 #define HUFFMAN_SUCCESS 0
@@ -20,14 +23,23 @@
 #define HUFFMAN_SYMBOLS 256
 #define HUFFMAN_MAX_CODE_LENGTH 256
 
+/* Bits de la tabla primaria del decodificador (resuelve la mayoría de
+   símbolos con una sola lectura) */
+#define HUFFMAN_LUT_BITS 10
+
 /**
  * @brief Estructura para almacenar datos comprimidos
+ * @details La compresión genera códigos canónicos (formato v2, que solo
+ *          serializa las longitudes); los archivos legacy conservan la
+ *          tabla de frecuencias y se decodifican con el árbol original.
  */
 typedef struct {
     uint8_t *data;           /* Datos comprimidos */
     size_t size;             /* Tamaño de datos comprimidos */
     size_t original_size;    /* Tamaño original */
-    uint32_t freq_table[HUFFMAN_SYMBOLS]; /* Tabla de frecuencias */
+    uint32_t freq_table[HUFFMAN_SYMBOLS]; /* Tabla de frecuencias (legacy) */
+    uint8_t code_lengths[HUFFMAN_SYMBOLS]; /* Longitudes canónicas (v2) */
+    bool canonical;          /* true: bitstream con códigos canónicos */
 } huffman_compressed_t;
 
 /**
@@ -72,4 +84,36 @@ int huffman_serialize(const huffman_compressed_t *compressed, uint8_t **output,
  */
 int huffman_deserialize(const uint8_t *input, size_t input_size, huffman_compressed_t **compressed);
 
+/**
+ * @brief Comprime directamente al formato serializado v2 (sin copia intermedia)
+ * @param input Buffer de entrada
+ * @param output Buffer con los datos serializados (data debe liberarse)
+ * @return HUFFMAN_SUCCESS en éxito, código de error en caso contrario
+ */
+int huffman_encode(const file_buffer_t *input, file_buffer_t *output);
+
+/**
+ * @brief Comprime al formato v2 paralelizando histograma y emisión de bits
+ * @details Fase 1: histogramas por porción en el pool, fusionados en una
+ *          tabla única. Fase 2: cada porción emite sus bits directamente en
+ *          el offset calculado por prefix-sum de las longitudes. La salida
+ *          es HUF2 estándar, idéntica en formato a huffman_encode().
+ *          Entradas pequeñas o pool NULL delegan en la ruta serial.
+ * @param input Buffer de entrada
+ * @param output Buffer con los datos serializados
+ * @param pool Pool de hilos para las fases (puede ser NULL)
+ * @return HUFFMAN_SUCCESS en éxito, código de error en caso contrario
+ */
+int huffman_encode_parallel(const file_buffer_t *input, file_buffer_t *output,
+                            thread_pool_t *pool);
+
+/**
+ * @brief Descomprime directamente desde el formato serializado
+ * @details Decodifica v2 en el sitio; los archivos legacy usan la ruta clásica
+ * @param input Buffer serializado
+ * @param output Buffer de salida (data debe liberarse)
+ * @return HUFFMAN_SUCCESS en éxito, código de error en caso contrario
+ */
+int huffman_decode(const file_buffer_t *input, file_buffer_t *output);
+
 #endif /* HUFFMAN_H */
\ No newline at end of file
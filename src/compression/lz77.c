@@ -10,8 +10,12 @@
  *  - Búsqueda hacia adelante de 18 bytes
  *  - Longitud mínima de coincidencia: 3 bytes
  *  - Hash table de 65536 entradas (16-bit hash)
- *  - Token: <offset (16), length (8), next_char (8)>
- *  - Header: 8 bytes (tamaño original)
+ *  - Formato v2 (se emite): bits de flag por grupo de 8 ítems; literal de
+ *    1 byte, match de 2 bytes <offset-1 (12), length-3 (4)>
+ *  - Formato v1 (solo lectura): token fijo <offset (16), length (8),
+ *    next_char (8)> — cuadruplicaba los literales
+ *  - Header: 8 bytes; el primer byte distingue la versión (0x02 = v2,
+ *    0x00 = v1, ya que ningún tamaño real usa el byte alto)
  *
  * Justificación técnica:
  *  - LZ77 es ideal para datos repetitivos (texto, logs, genómica)
@@ -26,6 +30,7 @@
 
 #include "lz77.h"
 #include "../common.h"
+#include "../utils/buffer_pool.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
@@ -37,24 +42,118 @@
 #define HASH_TABLE_SIZE   65536u     /* 2^16 entradas */
 #define HASH_MASK         (HASH_TABLE_SIZE - 1)
 
-/* Token LZ77: 4 bytes */
+/* Versión de formato en el byte alto del header de 8 bytes: los archivos
+   v1 siempre llevan 0x00 ahí (ningún tamaño alcanza 2^56) */
+#define LZ77_FORMAT_V2    0x02
+#define LZ77_FORMAT_V2_DICT 0x03     /* v2 + diccionario preset (id de 4 bytes) */
+
+/* Token LZ77 v1: 4 bytes (solo se usa al decodificar archivos viejos) */
 typedef struct {
     uint16_t offset;     /* 0 = literal */
     uint8_t length;
     uint8_t next_char;
 } lz77_token_t;
 
-/* ==================== TABLA HASH ESTÁTICA ==================== */
-/* Usamos static para que sea única por hilo (segura en thread_pool) */
-static uint16_t hash_table[HASH_TABLE_SIZE];
-
 /* Hash de 3 bytes: (a << 16) | (b << 8) | c */
 static inline uint32_t compute_hash(const uint8_t *p) {
     return ((uint32_t)p[0] << 16) | ((uint32_t)p[1] << 8) | p[2];
 }
 
-/* ==================== FUNCIÓN DE BÚSQUEDA OPTIMIZADA ==================== */
-static size_t find_longest_match(const uint8_t *data, size_t pos, size_t data_size,
+/* ==================== NIVELES DE COMPRESIÓN ==================== */
+/* Cada nivel fija cuántos candidatos de la cadena hash se examinan y si
+   se aplica lazy matching (diferir un match si en pos+1 hay uno mejor) */
+typedef struct {
+    uint16_t max_chain;   /* Candidatos máximos por búsqueda */
+    bool lazy;            /* Evaluar también el match en pos+1 */
+} lz77_level_params_t;
+
+static const lz77_level_params_t LZ77_LEVELS[LZ77_MAX_LEVEL + 1] = {
+    {0,    false},   /* 0: no usado */
+    {4,    false},   /* 1: más rápido */
+    {8,    false},
+    {16,   false},
+    {32,   true},
+    {64,   true},
+    {128,  true},    /* 6: por defecto */
+    {256,  true},
+    {512,  true},
+    {1024, true},    /* 9: mejor ratio */
+};
+
+/* Nivel global: se fija una vez antes de comprimir y los workers solo lo
+   leen, por lo que sigue siendo seguro con bloques en paralelo */
+static int lz77_level = LZ77_DEFAULT_LEVEL;
+
+void lz77_set_level(int level) {
+    if (level < LZ77_MIN_LEVEL || level > LZ77_MAX_LEVEL) {
+        LOG_ERROR("Invalid LZ77 level %d, keeping %d", level, lz77_level);
+        return;
+    }
+    lz77_level = level;
+}
+
+/* ==================== DICCIONARIO PRESET ==================== */
+/* Igual que el nivel: se fija una vez antes de procesar y los workers solo
+   lo leen. El caller es dueño de la memoria y debe mantenerla viva */
+static const uint8_t *lz77_dict = NULL;
+static size_t lz77_dict_len = 0;
+static uint32_t lz77_dict_id = 0;
+
+/* FNV-1a de 32 bits: identifica el diccionario en el header */
+static uint32_t fnv1a32(const uint8_t *data, size_t size) {
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        h ^= data[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void lz77_set_dictionary(const uint8_t *data, size_t size) {
+    if (!data || size == 0) {
+        lz77_dict = NULL;
+        lz77_dict_len = 0;
+        return;
+    }
+    /* Solo la cola cabe en la ventana deslizante */
+    if (size > WINDOW_SIZE) {
+        data += size - WINDOW_SIZE;
+        size = WINDOW_SIZE;
+    }
+    lz77_dict = data;
+    lz77_dict_len = size;
+    lz77_dict_id = fnv1a32(data, size);
+}
+
+/* ==================== BUSCADOR DE MATCHES (HASH CHAINS) ==================== */
+/* head[hash] guarda la posición más reciente con ese hash y prev[pos & mask]
+   enlaza con la anterior, como en deflate. Las estructuras se asignan por
+   llamada para que lz77_compress sea seguro cuando varios hilos comprimen
+   bloques en paralelo */
+#define LZ77_POS_NONE UINT32_MAX
+
+typedef struct {
+    uint32_t *head;   /* HASH_TABLE_SIZE entradas */
+    uint32_t *prev;   /* WINDOW_SIZE entradas, indexado pos & (WINDOW_SIZE-1) */
+} match_finder_t;
+
+/**
+ * @brief Registra la posición actual en las cadenas hash
+ */
+static inline void insert_position(match_finder_t *mf, const uint8_t *data,
+                                   size_t pos, size_t data_size) {
+    if (pos + 2 >= data_size) return;
+    uint32_t hash = compute_hash(&data[pos]) & HASH_MASK;
+    mf->prev[pos & (WINDOW_SIZE - 1)] = mf->head[hash];
+    mf->head[hash] = (uint32_t)pos;
+}
+
+/**
+ * @brief Busca el match más largo recorriendo la cadena de candidatos
+ */
+static size_t find_longest_match(const match_finder_t *mf,
+                                 const uint8_t *data, size_t pos, size_t data_size,
+                                 size_t max_chain,
                                  size_t *best_offset, size_t *best_length) {
     size_t window_start = (pos > WINDOW_SIZE) ? pos - WINDOW_SIZE : 0;
     size_t lookahead_end = (pos + LOOKAHEAD_SIZE < data_size) ? pos + LOOKAHEAD_SIZE : data_size;
@@ -66,10 +165,14 @@ static size_t find_longest_match(const uint8_t *data, size_t pos, size_t data_si
     if (pos + 2 >= data_size) return 0;
 
     uint32_t hash = compute_hash(&data[pos]) & HASH_MASK;
-    uint32_t candidate = hash_table[hash];
+    uint32_t candidate = mf->head[hash];
+
+    for (size_t chain = 0; chain < max_chain; chain++) {
+        if (candidate == LZ77_POS_NONE || candidate < window_start ||
+            candidate >= pos) {
+            break;
+        }
 
-    /* Solo un candidato por hash (última posición) */
-    if (candidate >= window_start && candidate < pos) {
         if (data[candidate] == data[pos] &&
             data[candidate + 1] == data[pos + 1] &&
             data[candidate + 2] == data[pos + 2]) {
@@ -80,36 +183,34 @@ static size_t find_longest_match(const uint8_t *data, size_t pos, size_t data_si
                 match_len++;
             }
 
-            *best_length = match_len;
-            *best_offset = pos - candidate;
+            if (match_len > *best_length) {
+                *best_length = match_len;
+                *best_offset = pos - candidate;
+                if (match_len >= LOOKAHEAD_SIZE) break; /* No puede mejorar */
+            }
         }
-    }
 
-    /* Actualizar hash table (sobrescribe) */
-    hash_table[hash] = (uint16_t)pos;
+        /* Seguir la cadena; las posiciones deben decrecer estrictamente
+           (una entrada reciclada de prev apuntaría hacia adelante) */
+        uint32_t next = mf->prev[candidate & (WINDOW_SIZE - 1)];
+        if (next >= candidate) break;
+        candidate = next;
+    }
 
     return *best_length;
 }
 
-/* ==================== ESCRITURA DE TOKEN ==================== */
-static int write_token(file_buffer_t *output, const lz77_token_t *token) {
-    if (output->size + 4 > output->capacity) {
-        size_t new_cap = (output->capacity < 8192) ? 8192 : output->capacity * 2;
-        uint8_t *new_data = realloc(output->data, new_cap);
-        if (!new_data) return GSEA_ERROR_MEMORY;
-        output->data = new_data;
-        output->capacity = new_cap;
+/* ==================== ESCRITURA V2 (BIT-PACKED) ==================== */
+/* Garantiza espacio para la siguiente emisión (flag + match de 2 bytes) */
+static int ensure_space(file_buffer_t *output, size_t extra) {
+    if (output->size + extra <= output->capacity) {
+        return GSEA_SUCCESS;
     }
-
-    output->data[output->size++] = (token->offset >> 8) & 0xFF;
-    output->data[output->size++] = token->offset & 0xFF;
-    output->data[output->size++] = token->length;
-    output->data[output->size++] = token->next_char;
-
-    return GSEA_SUCCESS;
+    size_t new_cap = MAX(output->capacity * 2, output->size + extra);
+    return buffer_reserve(output, new_cap);
 }
 
-/* ==================== LECTURA DE TOKEN ==================== */
+/* ==================== LECTURA DE TOKEN V1 ==================== */
 static int read_token(const file_buffer_t *input, size_t *pos, lz77_token_t *token) {
     if (*pos + 4 > input->size) return GSEA_ERROR_COMPRESSION;
 
@@ -128,53 +229,149 @@ int lz77_compress(const file_buffer_t *input, file_buffer_t *output) {
         return GSEA_ERROR_ARGS;
     }
 
-    LOG_INFO("Starting LZ77 compression (%zu bytes)", input->size);
+    const lz77_level_params_t *params = &LZ77_LEVELS[lz77_level];
 
-    /* Inicializar hash table */
-    memset(hash_table, 0, sizeof(hash_table));
+    LOG_INFO("Starting LZ77 compression (%zu bytes, level %d)",
+             input->size, lz77_level);
 
-    /* Buffer de salida */
-    output->capacity = input->size + (input->size / 10) + 1024; /* +10% + header */
-    output->data = malloc(output->capacity);
-    output->size = 0;
-    if (!output->data) {
+    /* Estructuras de búsqueda locales a la llamada (thread-safe) */
+    match_finder_t mf;
+    mf.head = malloc(HASH_TABLE_SIZE * sizeof(uint32_t));
+    mf.prev = malloc(WINDOW_SIZE * sizeof(uint32_t));
+    if (!mf.head || !mf.prev) {
         LOG_ERROR("Memory allocation failed");
+        free(mf.head);
+        free(mf.prev);
         return GSEA_ERROR_MEMORY;
     }
+    memset(mf.head, 0xFF, HASH_TABLE_SIZE * sizeof(uint32_t)); /* LZ77_POS_NONE */
+    memset(mf.prev, 0xFF, WINDOW_SIZE * sizeof(uint32_t));
+
+    /* Con diccionario preset la ventana arranca sembrada con su cola: los
+       primeros bytes del archivo pueden referenciar hacia el diccionario */
+    const uint8_t *data = input->data;
+    size_t total = input->size;
+    size_t start = 0;
+    uint8_t *scratch = NULL;
+    if (lz77_dict) {
+        scratch = malloc(lz77_dict_len + input->size);
+        if (!scratch) {
+            free(mf.head);
+            free(mf.prev);
+            return GSEA_ERROR_MEMORY;
+        }
+        memcpy(scratch, lz77_dict, lz77_dict_len);
+        memcpy(scratch + lz77_dict_len, input->data, input->size);
+        data = scratch;
+        total = lz77_dict_len + input->size;
+        start = lz77_dict_len;
+    }
 
-    /* Header: tamaño original (8 bytes, big-endian) */
+    /* Buffer de salida: peor caso v2 = 1 byte por literal + 1 flag por
+       cada 8 ítems (12.5% de expansión, vs 300% del token fijo v1) */
+    output->size = 0;
+    if (buffer_reserve(output, input->size + (input->size / 8) + 1024)
+            != GSEA_SUCCESS) {
+        free(scratch);
+        free(mf.head);
+        free(mf.prev);
+        return GSEA_ERROR_MEMORY;
+    }
+
+    /* Header: versión (1 byte) + tamaño original (7 bytes, big-endian);
+       con diccionario se añade su id para detectar desajustes al leer */
     uint64_t orig_size = input->size;
-    for (int i = 7; i >= 0; i--) {
+    output->data[output->size++] = lz77_dict ? LZ77_FORMAT_V2_DICT
+                                             : LZ77_FORMAT_V2;
+    for (int i = 6; i >= 0; i--) {
         output->data[output->size++] = (orig_size >> (i * 8)) & 0xFF;
     }
+    if (lz77_dict) {
+        for (int i = 3; i >= 0; i--) {
+            output->data[output->size++] = (lz77_dict_id >> (i * 8)) & 0xFF;
+        }
+    }
 
-    size_t pos = 0;
-    while (pos < input->size) {
-        lz77_token_t token = {0};
-        size_t best_offset = 0, best_length = 0;
+    /* Indexar las posiciones del diccionario en las cadenas hash */
+    for (size_t j = 0; j < start; j++) {
+        insert_position(&mf, data, j, total);
+    }
 
-        find_longest_match(input->data, pos, input->size, &best_offset, &best_length);
+    /* Grupo de flags: un byte cada 8 ítems, bit encendido = match */
+    size_t flag_pos = 0;
+    uint8_t flag_bits = 0;
+    int flag_count = 8;     /* Fuerza abrir un grupo en el primer ítem */
 
-        if (best_length >= MIN_MATCH_LENGTH) {
-            token.offset = (uint16_t)best_offset;
-            token.length = (uint8_t)best_length;
-            token.next_char = (pos + best_length < input->size)
-                              ? input->data[pos + best_length] : 0;
-            pos += best_length + 1;
-        } else {
-            token.offset = 0;
-            token.length = 0;
-            token.next_char = input->data[pos];
-            pos++;
+    size_t pos = start;
+    while (pos < total) {
+        size_t best_offset = 0, best_length = 0;
+
+        find_longest_match(&mf, data, pos, total,
+                           params->max_chain, &best_offset, &best_length);
+        insert_position(&mf, data, pos, total);
+
+        /* Lazy matching: si en pos+1 hay un match más largo, emitir un
+           literal y dejar que la siguiente iteración lo aproveche */
+        if (params->lazy && best_length >= MIN_MATCH_LENGTH &&
+            best_length < LOOKAHEAD_SIZE && pos + 1 < total) {
+            size_t next_offset = 0, next_length = 0;
+            find_longest_match(&mf, data, pos + 1, total,
+                               params->max_chain, &next_offset, &next_length);
+            if (next_length > best_length) {
+                best_length = 0;
+            }
         }
 
-        if (write_token(output, &token) != GSEA_SUCCESS) {
+        if (ensure_space(output, 3) != GSEA_SUCCESS) {
             free(output->data);
             output->data = NULL;
+            free(scratch);
+            free(mf.head);
+            free(mf.prev);
             return GSEA_ERROR_COMPRESSION;
         }
+
+        /* Abrir un grupo nuevo de flags si el actual está completo */
+        if (flag_count == 8) {
+            if (flag_pos) {
+                output->data[flag_pos] = flag_bits;
+            }
+            flag_pos = output->size++;
+            flag_bits = 0;
+            flag_count = 0;
+        }
+
+        if (best_length >= MIN_MATCH_LENGTH) {
+            /* Match de 2 bytes: offset-1 en 12 bits, length-3 en 4 bits
+               (la ventana de 4096 y el lookahead de 18 caben exactos) */
+            uint16_t off = (uint16_t)(best_offset - 1);
+            uint8_t len = (uint8_t)(best_length - MIN_MATCH_LENGTH);
+            flag_bits |= (uint8_t)(1u << flag_count);
+            output->data[output->size++] = (uint8_t)(off >> 4);
+            output->data[output->size++] = (uint8_t)((off & 0x0F) << 4 | len);
+
+            /* Indexar también las posiciones cubiertas por el match */
+            size_t covered_end = MIN(pos + best_length, total);
+            for (size_t j = pos + 1; j < covered_end; j++) {
+                insert_position(&mf, data, j, total);
+            }
+            pos += best_length;
+        } else {
+            output->data[output->size++] = data[pos];
+            pos++;
+        }
+        flag_count++;
+    }
+
+    /* Cerrar el último grupo de flags */
+    if (flag_pos) {
+        output->data[flag_pos] = flag_bits;
     }
 
+    free(scratch);
+    free(mf.head);
+    free(mf.prev);
+
     double ratio = input->size > 0
         ? (1.0 - (double)output->size / input->size) * 100.0
         : 0.0;
@@ -186,35 +383,132 @@ int lz77_compress(const file_buffer_t *input, file_buffer_t *output) {
 }
 
 /* ==================== DESCOMPRESIÓN LZ77 ==================== */
+
+/**
+ * @brief Decodifica el formato v2 (flags + literales/matches empaquetados)
+ */
+static int decompress_v2(const file_buffer_t *input, file_buffer_t *output,
+                         uint64_t target_size, size_t data_start) {
+    size_t pos = data_start;
+    uint8_t flag_bits = 0;
+    int flag_count = 8;
+
+    while (output->size < target_size) {
+        if (flag_count == 8) {
+            if (pos >= input->size) {
+                return GSEA_ERROR_COMPRESSION;
+            }
+            flag_bits = input->data[pos++];
+            flag_count = 0;
+        }
+
+        if (flag_bits & (1u << flag_count)) {
+            /* Match: offset-1 (12 bits) + length-3 (4 bits) */
+            if (pos + 2 > input->size) {
+                return GSEA_ERROR_COMPRESSION;
+            }
+            size_t offset = ((size_t)input->data[pos] << 4 |
+                             (input->data[pos + 1] >> 4)) + 1;
+            size_t length = (input->data[pos + 1] & 0x0F) + MIN_MATCH_LENGTH;
+            pos += 2;
+
+            if (offset > output->size ||
+                output->size + length > target_size) {
+                LOG_ERROR("Invalid reference in LZ77 v2 stream");
+                return GSEA_ERROR_COMPRESSION;
+            }
+            size_t ref_pos = output->size - offset;
+            for (size_t i = 0; i < length; i++) {
+                output->data[output->size++] = output->data[ref_pos + i];
+            }
+        } else {
+            if (pos >= input->size) {
+                return GSEA_ERROR_COMPRESSION;
+            }
+            output->data[output->size++] = input->data[pos++];
+        }
+        flag_count++;
+    }
+
+    return GSEA_SUCCESS;
+}
+
 int lz77_decompress(const file_buffer_t *input, file_buffer_t *output) {
-    if (!input || !output || !input->data || input->size < 12) {
+    if (!input || !output || !input->data || input->size < 9) {
         LOG_ERROR("Invalid parameters for LZ77 decompression");
         return GSEA_ERROR_ARGS;
     }
 
     LOG_INFO("Starting LZ77 decompression");
 
-    /* Leer tamaño original */
+    /* El primer byte del header lleva la versión de formato; los archivos
+       v1 siempre tienen 0x00 ahí (el byte alto del tamaño) */
+    uint8_t version = input->data[0];
+    bool v2 = (version == LZ77_FORMAT_V2 || version == LZ77_FORMAT_V2_DICT);
+
+    /* Leer tamaño original (v2 usa solo 7 bytes) */
     uint64_t orig_size = 0;
-    for (int i = 0; i < 8; i++) {
+    for (int i = v2 ? 1 : 0; i < 8; i++) {
         orig_size = (orig_size << 8) | input->data[i];
     }
 
+    /* Con diccionario: validar el id del header contra el cargado */
+    size_t data_start = 8;
+    size_t prefix = 0;
+    if (version == LZ77_FORMAT_V2_DICT) {
+        if (input->size < 13) {
+            return GSEA_ERROR_COMPRESSION;
+        }
+        uint32_t id = 0;
+        for (int i = 8; i < 12; i++) {
+            id = (id << 8) | input->data[i];
+        }
+        if (!lz77_dict || id != lz77_dict_id) {
+            LOG_ERROR("LZ77 stream requires preset dictionary id %08x "
+                      "(pass the original --dict file)", id);
+            return GSEA_ERROR_COMPRESSION;
+        }
+        data_start = 12;
+        prefix = lz77_dict_len;
+    }
+
     if (orig_size == 0) {
         output->size = 0;
         output->data = NULL;
         return GSEA_SUCCESS;
     }
 
-    /* Buffer de salida */
-    output->capacity = (size_t)orig_size + 1024;
-    output->data = malloc(output->capacity);
+    /* Buffer de salida: dimensionado una sola vez por adelantado */
     output->size = 0;
-    if (!output->data) {
-        LOG_ERROR("Memory allocation failed");
+    if (buffer_reserve(output, (size_t)orig_size + prefix + 1024)
+            != GSEA_SUCCESS) {
         return GSEA_ERROR_MEMORY;
     }
 
+    if (v2) {
+        /* El diccionario se antepone como historial y se recorta al final */
+        if (prefix) {
+            memcpy(output->data, lz77_dict, prefix);
+            output->size = prefix;
+        }
+        int result = decompress_v2(input, output, orig_size + prefix,
+                                   data_start);
+        if (result != GSEA_SUCCESS) {
+            LOG_ERROR("Corrupted LZ77 v2 stream");
+            free(output->data);
+            output->data = NULL;
+            return result;
+        }
+        if (prefix) {
+            memmove(output->data, output->data + prefix, (size_t)orig_size);
+            output->size = (size_t)orig_size;
+        }
+        LOG_INFO("LZ77 decompression complete: %zu → %zu bytes",
+                 input->size, output->size);
+        return GSEA_SUCCESS;
+    }
+
+    /* Formato v1 heredado: tokens fijos de 4 bytes */
     size_t pos = 8;
     while (pos < input->size && output->size < orig_size) {
         lz77_token_t token;
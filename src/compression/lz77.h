@@ -3,7 +3,30 @@
 
 #include "../common.h"
 
+/* Niveles de compresión: velocidad (1) <-> ratio (9) */
+#define LZ77_MIN_LEVEL     1
+#define LZ77_MAX_LEVEL     9
+#define LZ77_DEFAULT_LEVEL 6
+
+/**
+ * @brief Fija el nivel de compresión para las siguientes llamadas
+ * @param level Nivel entre LZ77_MIN_LEVEL y LZ77_MAX_LEVEL
+ */
+void lz77_set_level(int level);
+
+/**
+ * @brief Fija el diccionario preset para las siguientes llamadas
+ * @details La cola (hasta 4096 bytes) siembra la ventana deslizante, así
+ *          archivos chicos casi idénticos comparten historial desde el
+ *          primer byte. Un id FNV-1a del diccionario viaja en el header y
+ *          la descompresión exige el mismo diccionario cargado. El caller
+ *          es dueño de la memoria y debe mantenerla viva. NULL lo quita.
+ * @param data Bytes del diccionario
+ * @param size Tamaño en bytes
+ */
+void lz77_set_dictionary(const uint8_t *data, size_t size);
+
 int lz77_compress(const file_buffer_t *input, file_buffer_t *output);
 int lz77_decompress(const file_buffer_t *input, file_buffer_t *output);
 
-#endif
\ No newline at end of file
+#endif
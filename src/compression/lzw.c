@@ -4,6 +4,7 @@
  */
 
  #include "lzw.h"
+#include "../utils/buffer_pool.h"
  #include "../common.h"
  #include <stdlib.h>
  #include <string.h>
@@ -16,21 +17,109 @@
      bool used;            /* Si la entrada está en uso */
  } dict_entry_t;
  
+ /* Índice hash (prefijo, carácter) -> código con direccionamiento abierto.
+    El doble de entradas que el diccionario garantiza factor de carga <= 0.5,
+    por lo que el sondeo lineal siempre termina */
+ #define LZW_HASH_SIZE 8192            /* 2^13 = 2 * LZW_MAX_DICT_SIZE */
+ #define LZW_HASH_EMPTY 0xFFFF         /* Slot sin ocupar */
+
  /**
-  * @brief Busca secuencia en el diccionario
+  * @brief Hash multiplicativo del par (prefijo, carácter)
   */
- static int find_in_dict(dict_entry_t *dict, size_t dict_size, 
-                        uint16_t prefix, uint8_t character) {
-     for (size_t i = 0; i < dict_size; i++) {
-         if (dict[i].used && 
-             dict[i].prefix == prefix && 
-             dict[i].character == character) {
-             return i;
+ static size_t lzw_hash(uint16_t prefix, uint8_t character) {
+     uint32_t key = ((uint32_t)prefix << 8) | character;
+     return (key * 2654435761u) >> 19;  /* 13 bits altos -> [0, 8192) */
+ }
+
+ /**
+  * @brief Busca secuencia en el índice hash
+  * @return Código del diccionario, o -1 si no existe
+  */
+ static int find_in_dict(const uint16_t *hash_table, const dict_entry_t *dict,
+                         uint16_t prefix, uint8_t character) {
+     size_t slot = lzw_hash(prefix, character);
+     while (hash_table[slot] != LZW_HASH_EMPTY) {
+         uint16_t code = hash_table[slot];
+         if (dict[code].prefix == prefix && dict[code].character == character) {
+             return code;
          }
+         slot = (slot + 1) & (LZW_HASH_SIZE - 1);
      }
      return -1;
  }
+
+ /**
+  * @brief Inserta un código nuevo en el índice hash
+  */
+ static void insert_in_dict(uint16_t *hash_table, uint16_t prefix,
+                            uint8_t character, uint16_t code) {
+     size_t slot = lzw_hash(prefix, character);
+     while (hash_table[slot] != LZW_HASH_EMPTY) {
+         slot = (slot + 1) & (LZW_HASH_SIZE - 1);
+     }
+     hash_table[slot] = code;
+ }
  
+ /* ==================== DICCIONARIO PRESET ==================== */
+ /* Se fija una vez antes de procesar y los workers solo lo leen (mismo
+    contrato que lz77_set_dictionary). El flag en el header marca streams
+    que requieren el diccionario para decodificarse */
+ #define LZW_DICT_FLAG (1ULL << 63)
+
+ static const uint8_t *lzw_dict = NULL;
+ static size_t lzw_dict_len = 0;
+ static uint32_t lzw_dict_id = 0;
+
+ /* FNV-1a de 32 bits: identifica el diccionario en el header */
+ static uint32_t lzw_fnv1a32(const uint8_t *data, size_t size) {
+     uint32_t h = 2166136261u;
+     for (size_t i = 0; i < size; i++) {
+         h ^= data[i];
+         h *= 16777619u;
+     }
+     return h;
+ }
+
+ void lzw_set_dictionary(const uint8_t *data, size_t size) {
+     if (!data || size == 0) {
+         lzw_dict = NULL;
+         lzw_dict_len = 0;
+         return;
+     }
+     lzw_dict = data;
+     lzw_dict_len = size;
+     lzw_dict_id = lzw_fnv1a32(data, size);
+ }
+
+ /**
+  * @brief Precarga el diccionario preset con el algoritmo del encoder
+  * @details Recorre los bytes del diccionario insertando secuencias sin
+  *          emitir códigos. Encoder y decoder ejecutan exactamente esta
+  *          misma pasada, por lo que ambos llegan a la misma tabla.
+  * @return Tamaño del diccionario tras la precarga
+  */
+ static size_t preload_preset(uint16_t *hash_table, dict_entry_t *dict,
+                              size_t dict_size) {
+     uint16_t w = lzw_dict[0];
+     for (size_t i = 1; i < lzw_dict_len; i++) {
+         uint8_t k = lzw_dict[i];
+         int code = find_in_dict(hash_table, dict, w, k);
+         if (code != -1) {
+             w = code;
+         } else {
+             if (dict_size < LZW_MAX_DICT_SIZE) {
+                 dict[dict_size].prefix = w;
+                 dict[dict_size].character = k;
+                 dict[dict_size].used = true;
+                 insert_in_dict(hash_table, w, k, (uint16_t)dict_size);
+                 dict_size++;
+             }
+             w = k;
+         }
+     }
+     return dict_size;
+ }
+
  /**
   * @brief Comprime datos usando LZW
   */
@@ -52,11 +141,21 @@
          dict[i].used = true;
      }
      size_t dict_size = LZW_INIT_DICT_SIZE + 1; /* +1 para CLEAR_CODE */
-     
+
+     /* Índice hash vacío (los símbolos iniciales no tienen prefijo y nunca
+        se buscan como par, así que no necesitan indexarse) */
+     uint16_t *hash_table = malloc(LZW_HASH_SIZE * sizeof(uint16_t));
+     if (!hash_table) {
+         free(dict);
+         return LZW_ERROR_MEMORY;
+     }
+     memset(hash_table, 0xFF, LZW_HASH_SIZE * sizeof(uint16_t));
+
      /* Asignar buffer de códigos (peor caso: 1 código por byte) */
      size_t codes_capacity = input_size + 256;
      uint16_t *codes = malloc(codes_capacity * sizeof(uint16_t));
      if (!codes) {
+         free(hash_table);
          free(dict);
          return LZW_ERROR_MEMORY;
      }
@@ -69,7 +168,7 @@
          uint8_t k = input[i];
          
          /* Buscar w+k en el diccionario */
-         int code = find_in_dict(dict, dict_size, w, k);
+         int code = find_in_dict(hash_table, dict, w, k);
          
          if (code != -1) {
              /* w+k existe, actualizar w */
@@ -82,6 +181,7 @@
                  uint16_t *new_codes = realloc(codes, codes_capacity * sizeof(uint16_t));
                  if (!new_codes) {
                      free(codes);
+                     free(hash_table);
                      free(dict);
                      return LZW_ERROR_MEMORY;
                  }
@@ -94,6 +194,7 @@
                  dict[dict_size].prefix = w;
                  dict[dict_size].character = k;
                  dict[dict_size].used = true;
+                 insert_in_dict(hash_table, w, k, (uint16_t)dict_size);
                  dict_size++;
              }
              
@@ -109,6 +210,7 @@
      lzw_compressed_t *result = malloc(sizeof(lzw_compressed_t));
      if (!result) {
          free(codes);
+         free(hash_table);
          free(dict);
          return LZW_ERROR_MEMORY;
      }
@@ -122,7 +224,8 @@
      }
      result->code_count = code_count;
      result->original_size = input_size;
-     
+
+     free(hash_table);
      free(dict);
      *output = result;
      
@@ -195,7 +298,8 @@
          
          uint8_t *sequence;
          size_t seq_len;
-         
+         bool owns_sequence = false; /* true solo en el caso especial (malloc propio) */
+
          if (code < dict_size) {
              /* Código existe en diccionario */
              sequence = dict[code];
@@ -215,6 +319,7 @@
              }
              memcpy(sequence, dict[old_code], dict_lengths[old_code]);
              sequence[seq_len - 1] = dict[old_code][0];
+             owns_sequence = true;
          } else {
              /* Código inválido */
              free(result);
@@ -228,7 +333,7 @@
          
          /* Escribir secuencia */
          if (out_pos + seq_len > compressed->original_size) {
-             if (code == dict_size) free(sequence);
+             if (owns_sequence) free(sequence);
              free(result);
              for (int j = 0; j < LZW_INIT_DICT_SIZE; j++) free(dict[j]);
              for (size_t j = LZW_INIT_DICT_SIZE + 1; j < dict_size; j++) 
@@ -252,10 +357,13 @@
              }
          }
          
-         if (code == dict_size - 1) {
+         /* Liberar solo la secuencia temporal del caso especial: cuando el
+            diccionario está lleno, code == dict_size - 1 puede ser una
+            entrada legítima y liberarla causaba un double free */
+         if (owns_sequence) {
              free(sequence);
          }
-         
+
          old_code = code;
      }
      
@@ -362,7 +470,306 @@
          result->codes[i] = input[pos] | (input[pos + 1] << 8);
          pos += 2;
      }
-     
+
      *compressed = result;
      return LZW_SUCCESS;
+ }
+
+ /* ==================== RUTA DIRECTA (SIN COPIA INTERMEDIA) ==================== */
+ /* Emiten/leen los códigos directamente en el formato serializado sobre
+    file_buffer_t, sin pasar por lzw_compressed_t ni su array de códigos */
+
+ int lzw_encode(const file_buffer_t *input, file_buffer_t *output) {
+     if (!input || !output || !input->data || input->size == 0) {
+         return LZW_ERROR_INPUT;
+     }
+
+     /* Diccionario + índice hash, igual que lzw_compress */
+     dict_entry_t *dict = calloc(LZW_MAX_DICT_SIZE, sizeof(dict_entry_t));
+     if (!dict) {
+         return LZW_ERROR_MEMORY;
+     }
+     for (int i = 0; i < LZW_INIT_DICT_SIZE; i++) {
+         dict[i].prefix = 0xFFFF;
+         dict[i].character = i;
+         dict[i].used = true;
+     }
+     size_t dict_size = LZW_INIT_DICT_SIZE + 1; /* +1 para CLEAR_CODE */
+
+     uint16_t *hash_table = malloc(LZW_HASH_SIZE * sizeof(uint16_t));
+     if (!hash_table) {
+         free(dict);
+         return LZW_ERROR_MEMORY;
+     }
+     memset(hash_table, 0xFF, LZW_HASH_SIZE * sizeof(uint16_t));
+
+     /* Con diccionario preset el stream arranca con la tabla ya poblada y
+        el header crece 4 bytes para llevar el id */
+     if (lzw_dict) {
+         dict_size = preload_preset(hash_table, dict, dict_size);
+     }
+     size_t header_size = lzw_dict ? 20 : 16;
+
+     /* Peor caso conocido: un código (2 bytes) por byte de entrada */
+     if (buffer_reserve(output, header_size + input->size * 2 + 2) != GSEA_SUCCESS) {
+         free(hash_table);
+         free(dict);
+         return LZW_ERROR_MEMORY;
+     }
+
+     size_t pos = header_size; /* Header al final, cuando se conozca code_count */
+     size_t code_count = 0;
+     uint16_t w = input->data[0];
+
+     for (size_t i = 1; i < input->size; i++) {
+         uint8_t k = input->data[i];
+         int code = find_in_dict(hash_table, dict, w, k);
+
+         if (code != -1) {
+             w = code;
+         } else {
+             output->data[pos++] = w & 0xFF;
+             output->data[pos++] = (w >> 8) & 0xFF;
+             code_count++;
+
+             if (dict_size < LZW_MAX_DICT_SIZE) {
+                 dict[dict_size].prefix = w;
+                 dict[dict_size].character = k;
+                 dict[dict_size].used = true;
+                 insert_in_dict(hash_table, w, k, (uint16_t)dict_size);
+                 dict_size++;
+             }
+             w = k;
+         }
+     }
+
+     output->data[pos++] = w & 0xFF;
+     output->data[pos++] = (w >> 8) & 0xFF;
+     code_count++;
+
+     /* Header: [original_size:8][code_count:8] y, con diccionario preset,
+        el bit 63 de code_count encendido + [dict_id:4] */
+     memcpy(output->data, &input->size, 8);
+     uint64_t count_field = code_count;
+     if (lzw_dict) {
+         count_field |= LZW_DICT_FLAG;
+         output->data[16] = lzw_dict_id & 0xFF;
+         output->data[17] = (lzw_dict_id >> 8) & 0xFF;
+         output->data[18] = (lzw_dict_id >> 16) & 0xFF;
+         output->data[19] = (lzw_dict_id >> 24) & 0xFF;
+     }
+     memcpy(output->data + 8, &count_field, 8);
+     output->size = pos;
+
+     free(hash_table);
+     free(dict);
+     return LZW_SUCCESS;
+ }
+
+ int lzw_decode(const file_buffer_t *input, file_buffer_t *output) {
+     if (!input || !output || !input->data || input->size < 16) {
+         return LZW_ERROR_INPUT;
+     }
+
+     size_t original_size;
+     uint64_t count_field;
+     memcpy(&original_size, input->data, 8);
+     memcpy(&count_field, input->data + 8, 8);
+
+     bool has_dict = (count_field & LZW_DICT_FLAG) != 0;
+     size_t code_count = (size_t)(count_field & ~LZW_DICT_FLAG);
+     size_t header_size = has_dict ? 20 : 16;
+
+     if (has_dict) {
+         if (input->size < 20) {
+             return LZW_ERROR_CORRUPT;
+         }
+         uint32_t id = (uint32_t)input->data[16] |
+                       ((uint32_t)input->data[17] << 8) |
+                       ((uint32_t)input->data[18] << 16) |
+                       ((uint32_t)input->data[19] << 24);
+         if (!lzw_dict || id != lzw_dict_id) {
+             LOG_ERROR("LZW stream requires preset dictionary id %08x "
+                       "(pass the original --dict file)", id);
+             return LZW_ERROR_INPUT;
+         }
+     }
+
+     if (input->size != header_size + code_count * 2 || code_count == 0) {
+         return LZW_ERROR_CORRUPT;
+     }
+
+     /* Los códigos se leen directamente del buffer serializado */
+     const uint8_t *code_bytes = input->data + header_size;
+
+     uint8_t **dict = malloc(LZW_MAX_DICT_SIZE * sizeof(uint8_t *));
+     size_t *dict_lengths = calloc(LZW_MAX_DICT_SIZE, sizeof(size_t));
+     if (!dict || !dict_lengths) {
+         free(dict);
+         free(dict_lengths);
+         return LZW_ERROR_MEMORY;
+     }
+
+     for (int i = 0; i < LZW_INIT_DICT_SIZE; i++) {
+         dict[i] = malloc(1);
+         if (!dict[i]) {
+             for (int j = 0; j < i; j++) free(dict[j]);
+             free(dict);
+             free(dict_lengths);
+             return LZW_ERROR_MEMORY;
+         }
+         dict[i][0] = i;
+         dict_lengths[i] = 1;
+     }
+     dict[LZW_INIT_DICT_SIZE] = NULL; /* Slot del CLEAR_CODE, nunca se resuelve */
+     size_t dict_size = LZW_INIT_DICT_SIZE + 1;
+
+     /* Reconstruir las entradas preset: se simula la pasada del encoder con
+        sus mismas estructuras y luego se materializa cada secuencia. El
+        prefijo de una entrada siempre es un código anterior, así que las
+        cadenas se resuelven en orden */
+     if (has_dict) {
+         dict_entry_t *enc_dict = calloc(LZW_MAX_DICT_SIZE, sizeof(dict_entry_t));
+         uint16_t *enc_hash = malloc(LZW_HASH_SIZE * sizeof(uint16_t));
+         if (!enc_dict || !enc_hash) {
+             free(enc_dict);
+             free(enc_hash);
+             for (int i = 0; i < LZW_INIT_DICT_SIZE; i++) free(dict[i]);
+             free(dict);
+             free(dict_lengths);
+             return LZW_ERROR_MEMORY;
+         }
+         for (int i = 0; i < LZW_INIT_DICT_SIZE; i++) {
+             enc_dict[i].prefix = 0xFFFF;
+             enc_dict[i].character = i;
+             enc_dict[i].used = true;
+         }
+         memset(enc_hash, 0xFF, LZW_HASH_SIZE * sizeof(uint16_t));
+         size_t preset_size = preload_preset(enc_hash, enc_dict, dict_size);
+
+         for (size_t c = dict_size; c < preset_size; c++) {
+             uint16_t prefix = enc_dict[c].prefix;
+             size_t new_len = dict_lengths[prefix] + 1;
+             dict[c] = malloc(new_len);
+             if (!dict[c]) {
+                 free(enc_dict);
+                 free(enc_hash);
+                 for (int i = 0; i < LZW_INIT_DICT_SIZE; i++) free(dict[i]);
+                 for (size_t j = LZW_INIT_DICT_SIZE + 1; j < c; j++)
+                     if (dict[j]) free(dict[j]);
+                 free(dict);
+                 free(dict_lengths);
+                 return LZW_ERROR_MEMORY;
+             }
+             memcpy(dict[c], dict[prefix], dict_lengths[prefix]);
+             dict[c][new_len - 1] = enc_dict[c].character;
+             dict_lengths[c] = new_len;
+         }
+         dict_size = preset_size;
+         free(enc_dict);
+         free(enc_hash);
+     }
+
+     uint8_t *result = malloc(original_size ? original_size : 1);
+     if (!result) {
+         for (int i = 0; i < LZW_INIT_DICT_SIZE; i++) free(dict[i]);
+         for (size_t i = LZW_INIT_DICT_SIZE + 1; i < dict_size; i++)
+             if (dict[i]) free(dict[i]);
+         free(dict);
+         free(dict_lengths);
+         return LZW_ERROR_MEMORY;
+     }
+     size_t out_pos = 0;
+     int status = LZW_SUCCESS;
+
+     /* Con preset el primer código puede referir a una secuencia completa,
+        no solo a un símbolo simple */
+     uint16_t old_code = code_bytes[0] | (code_bytes[1] << 8);
+     if (old_code >= dict_size || !dict[old_code] ||
+         dict_lengths[old_code] > original_size) {
+         status = LZW_ERROR_CORRUPT;
+     } else {
+         memcpy(result, dict[old_code], dict_lengths[old_code]);
+         out_pos = dict_lengths[old_code];
+     }
+
+     for (size_t i = 1; status == LZW_SUCCESS && i < code_count; i++) {
+         uint16_t code = code_bytes[i * 2] | (code_bytes[i * 2 + 1] << 8);
+
+         uint8_t *sequence;
+         size_t seq_len;
+         bool owns_sequence = false;
+
+         if (code < dict_size) {
+             /* El slot 256 (CLEAR_CODE) queda reservado sin secuencia: un
+                stream que lo referencie está corrupto, igual que en el
+                guard del primer código */
+             if (!dict[code]) {
+                 status = LZW_ERROR_CORRUPT;
+                 break;
+             }
+             sequence = dict[code];
+             seq_len = dict_lengths[code];
+         } else if (code == dict_size) {
+             /* Caso especial: código aún no emitido */
+             seq_len = dict_lengths[old_code] + 1;
+             sequence = malloc(seq_len);
+             if (!sequence) {
+                 status = LZW_ERROR_MEMORY;
+                 break;
+             }
+             memcpy(sequence, dict[old_code], dict_lengths[old_code]);
+             sequence[seq_len - 1] = dict[old_code][0];
+             owns_sequence = true;
+         } else {
+             status = LZW_ERROR_CORRUPT;
+             break;
+         }
+
+         if (out_pos + seq_len > original_size) {
+             if (owns_sequence) free(sequence);
+             status = LZW_ERROR_CORRUPT;
+             break;
+         }
+         memcpy(result + out_pos, sequence, seq_len);
+         out_pos += seq_len;
+
+         if (dict_size < LZW_MAX_DICT_SIZE) {
+             size_t new_len = dict_lengths[old_code] + 1;
+             dict[dict_size] = malloc(new_len);
+             if (dict[dict_size]) {
+                 memcpy(dict[dict_size], dict[old_code], dict_lengths[old_code]);
+                 dict[dict_size][new_len - 1] = sequence[0];
+                 dict_lengths[dict_size] = new_len;
+                 dict_size++;
+             }
+         }
+
+         if (owns_sequence) {
+             free(sequence);
+         }
+         old_code = code;
+     }
+
+     if (status == LZW_SUCCESS && out_pos != original_size) {
+         status = LZW_ERROR_CORRUPT;
+     }
+
+     for (int i = 0; i < LZW_INIT_DICT_SIZE; i++) free(dict[i]);
+     for (size_t i = LZW_INIT_DICT_SIZE + 1; i < dict_size; i++) {
+         if (dict[i]) free(dict[i]);
+     }
+     free(dict);
+     free(dict_lengths);
+
+     if (status != LZW_SUCCESS) {
+         free(result);
+         return status;
+     }
+
+     free(output->data);    /* Soltar almacenamiento previo (pool) */
+     output->data = result;
+     output->size = original_size;
+     output->capacity = original_size;
+     return LZW_SUCCESS;
  }
\ No newline at end of file
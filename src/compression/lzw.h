@@ -84,5 +84,33 @@
   * @return LZW_SUCCESS o código de error
   */
  int lzw_deserialize(const uint8_t *input, size_t input_size, lzw_compressed_t **compressed);
- 
+
+ /**
+  * @brief Fija el diccionario preset para las siguientes llamadas
+  * @details Precarga la tabla de códigos con las secuencias del diccionario,
+  *          igual que la precarga de ventana en LZ77. Un id FNV-1a viaja en
+  *          el header (bit 63 de code_count encendido) y la descompresión
+  *          exige el mismo diccionario cargado. El caller es dueño de la
+  *          memoria y debe mantenerla viva. NULL lo quita.
+  * @param data Bytes del diccionario
+  * @param size Tamaño en bytes
+  */
+ void lzw_set_dictionary(const uint8_t *data, size_t size);
+
+ /**
+  * @brief Comprime directamente al formato serializado (sin copia intermedia)
+  * @param input Buffer de entrada
+  * @param output Buffer con los datos serializados (data debe liberarse)
+  * @return LZW_SUCCESS o código de error
+  */
+ int lzw_encode(const file_buffer_t *input, file_buffer_t *output);
+
+ /**
+  * @brief Descomprime directamente desde el formato serializado
+  * @param input Buffer serializado
+  * @param output Buffer de salida (data debe liberarse)
+  * @return LZW_SUCCESS o código de error
+  */
+ int lzw_decode(const file_buffer_t *input, file_buffer_t *output);
+
  #endif /* LZW_H */
\ No newline at end of file
@@ -4,10 +4,67 @@
  */
 
 #include "rle.h"
+#include "../utils/buffer_pool.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
+/* ==================== ESCANEO VECTORIZADO DE RUNS ==================== */
+/* La detección de fronteras de run es el costo completo del encoder: la
+   versión SSE2 compara 16 bytes por iteración y localiza el primer byte
+   distinto con movemask + ctz, con despacho en runtime y el bucle escalar
+   como respaldo (mismo patrón que los kernels de salsa20.c/chacha20.c) */
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define RLE_HAVE_SSE2 1
+
+static int rle_sse2_available(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        cached = __builtin_cpu_supports("sse2") ? 1 : 0;
+    }
+    return cached;
+}
+
+__attribute__((target("sse2")))
+static size_t scan_run_sse2(const uint8_t *data, size_t start, size_t limit) {
+    uint8_t value = data[start];
+    size_t i = start + 1;
+
+    __m128i ref = _mm_set1_epi8((char)value);
+    while (i + 16 <= limit) {
+        __m128i chunk = _mm_loadu_si128((const __m128i *)(data + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, ref));
+        if (mask != 0xFFFFu) {
+            /* Primer bit apagado = primer byte distinto del chunk */
+            return i - start + (size_t)__builtin_ctz(~mask);
+        }
+        i += 16;
+    }
+    while (i < limit && data[i] == value) {
+        i++;
+    }
+    return i - start;
+}
+#endif /* __x86_64__ || __i386__ */
+
+/**
+ * @brief Mide la longitud del run que arranca en start (acotada por limit)
+ */
+static size_t scan_run(const uint8_t *data, size_t start, size_t limit) {
+#ifdef RLE_HAVE_SSE2
+    if (rle_sse2_available()) {
+        return scan_run_sse2(data, start, limit);
+    }
+#endif
+    uint8_t value = data[start];
+    size_t i = start + 1;
+    while (i < limit && data[i] == value) {
+        i++;
+    }
+    return i - start;
+}
+
 /**
  * @brief Escribe una secuencia al buffer de salida
  * @details Formato simple: [count][value] donde count es 1-255
@@ -46,15 +103,11 @@ int rle_compress(const uint8_t *input, size_t input_size, rle_compressed_t **out
     
     while (i < input_size) {
         uint8_t current = input[i];
-        size_t run_length = 1;
-        
-        /* Contar longitud de la secuencia */
-        while (i + run_length < input_size && 
-               input[i + run_length] == current && 
-               run_length < RLE_MAX_RUN_LENGTH) {
-            run_length++;
-        }
-        
+
+        /* Contar longitud de la secuencia (escaneo vectorizado) */
+        size_t limit = MIN(input_size, i + RLE_MAX_RUN_LENGTH);
+        size_t run_length = scan_run(input, i, limit);
+
         /* Escribir run */
         int result = write_run(&buffer, &pos, &capacity, current, run_length);
         if (result != RLE_SUCCESS) {
@@ -205,7 +258,96 @@ int rle_deserialize(const uint8_t *input, size_t input_size, rle_compressed_t **
     }
     
     memcpy(result->data, input + pos, result->size);
-    
+
     *compressed = result;
     return RLE_SUCCESS;
+}
+
+/* ==================== RUTA DIRECTA (SIN COPIA INTERMEDIA) ==================== */
+/* Escriben/leen el formato serializado directamente sobre file_buffer_t,
+   evitando la estructura rle_compressed_t y su copia en el camino caliente */
+
+int rle_encode(const file_buffer_t *input, file_buffer_t *output) {
+    if (!input || !output || !input->data || input->size == 0) {
+        return RLE_ERROR_INPUT;
+    }
+
+    /* Peor caso conocido de antemano: 2 bytes por byte + header */
+    if (buffer_reserve(output, 16 + input->size * 2) != GSEA_SUCCESS) {
+        return RLE_ERROR_MEMORY;
+    }
+
+    size_t pos = 16; /* El header se escribe al final */
+    size_t i = 0;
+
+    while (i < input->size) {
+        uint8_t current = input->data[i];
+
+        /* Escaneo vectorizado de la frontera del run */
+        size_t limit = MIN(input->size, i + RLE_MAX_RUN_LENGTH);
+        size_t run_length = scan_run(input->data, i, limit);
+
+        output->data[pos++] = (uint8_t)run_length;
+        output->data[pos++] = current;
+        i += run_length;
+    }
+
+    /* Header: [original_size:8][compressed_size:8] */
+    size_t comp_size = pos - 16;
+    memcpy(output->data, &input->size, 8);
+    memcpy(output->data + 8, &comp_size, 8);
+    output->size = pos;
+
+    return RLE_SUCCESS;
+}
+
+int rle_decode(const file_buffer_t *input, file_buffer_t *output) {
+    if (!input || !output || !input->data || input->size < 16) {
+        return RLE_ERROR_INPUT;
+    }
+
+    size_t original_size, comp_size;
+    memcpy(&original_size, input->data, 8);
+    memcpy(&comp_size, input->data + 8, 8);
+
+    if (input->size != 16 + comp_size) {
+        return RLE_ERROR_CORRUPT;
+    }
+
+    if (buffer_reserve(output, original_size ? original_size : 1)
+            != GSEA_SUCCESS) {
+        return RLE_ERROR_MEMORY;
+    }
+
+    size_t in_pos = 16;
+    size_t out_pos = 0;
+
+    while (in_pos < input->size && out_pos < original_size) {
+        if (in_pos + 1 >= input->size) {
+            free(output->data);
+            output->data = NULL;
+            return RLE_ERROR_CORRUPT;
+        }
+
+        uint8_t count = input->data[in_pos++];
+        uint8_t value = input->data[in_pos++];
+
+        if (out_pos + count > original_size) {
+            free(output->data);
+            output->data = NULL;
+            return RLE_ERROR_CORRUPT;
+        }
+
+        memset(output->data + out_pos, value, count);
+        out_pos += count;
+    }
+
+    if (out_pos != original_size) {
+        free(output->data);
+        output->data = NULL;
+        return RLE_ERROR_CORRUPT;
+    }
+
+    output->size = original_size;
+    return RLE_SUCCESS;
 }
\ No newline at end of file
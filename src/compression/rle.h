@@ -7,6 +7,7 @@
 #ifndef RLE_H
 #define RLE_H
 
+#include "../common.h"
 #include <stdint.h>
 #include <stddef.h>
 
@@ -71,4 +72,20 @@ int rle_serialize(const rle_compressed_t *compressed, uint8_t **output, size_t *
  */
 int rle_deserialize(const uint8_t *input, size_t input_size, rle_compressed_t **compressed);
 
+/**
+ * @brief Comprime directamente al formato serializado (sin copia intermedia)
+ * @param input Buffer de entrada
+ * @param output Buffer con los datos serializados (data debe liberarse)
+ * @return RLE_SUCCESS en éxito, código de error en caso contrario
+ */
+int rle_encode(const file_buffer_t *input, file_buffer_t *output);
+
+/**
+ * @brief Descomprime directamente desde el formato serializado
+ * @param input Buffer serializado
+ * @param output Buffer de salida (data debe liberarse)
+ * @return RLE_SUCCESS en éxito, código de error en caso contrario
+ */
+int rle_decode(const file_buffer_t *input, file_buffer_t *output);
+
 #endif /* RLE_H */
\ No newline at end of file
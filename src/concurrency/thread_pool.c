@@ -1,91 +1,162 @@
 /**
  * @file thread_pool.c
- * @brief Implementación de un pool de hilos para procesamiento paralelo
- * @details Usa POSIX threads (pthreads) para procesamiento concurrente
+ * @brief Implementación de un pool de hilos con robo de trabajo
+ * @details Cada hilo tiene su propio deque de tareas preasignado: el
+ *          productor publica con operaciones atómicas (sin mutex) y los
+ *          consumidores — el dueño o un ladrón — compiten por el extremo
+ *          contrario con CAS. El mutex global solo se usa para dormir y
+ *          despertar hilos, no en el camino caliente de encolado.
  */
 
 #include "thread_pool.h"
 #include "../common.h"
 #include <pthread.h>
+#include <stdatomic.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-/* Estructura de nodo para la cola de tareas */
-typedef struct task_node {
+/* Capacidad de cada deque (potencia de dos). Con el slab preasignado no
+   hay malloc por tarea; si un deque se llena, la tarea se ejecuta en
+   línea en el hilo que la encola */
+#define DEQUE_CAPACITY 4096u
+
+/* Ranura de tarea: se guarda por valor, sin nodos enlazados */
+typedef struct {
     void (*function)(void *);
     void *arg;
-    struct task_node *next;
-} task_node_t;
+} task_slot_t;
 
-/* Estructura de cola de tareas */
+/* Deque SPMC: un solo productor (quien encola) avanza bottom; el hilo
+   dueño y los ladrones consumen desde top compitiendo con CAS */
 typedef struct {
-    task_node_t *head;
-    task_node_t *tail;
-    int count;
-} task_queue_t;
+    task_slot_t *slots;           /* Slab preasignado de DEQUE_CAPACITY */
+    _Atomic size_t top;           /* Extremo de consumo */
+    _Atomic size_t bottom;        /* Extremo de producción */
+} work_deque_t;
 
 /* Estructura del pool de hilos */
 struct thread_pool {
     pthread_t *threads;
+    work_deque_t *deques;         /* Un deque por hilo */
     int thread_count;
-    task_queue_t queue;
-    pthread_mutex_t queue_mutex;
-    pthread_cond_t queue_cond;
+    int next_deque;               /* Round-robin de encolado */
+
+    _Atomic size_t pending;       /* Tareas encoladas + en ejecución */
+    _Atomic size_t queued;        /* Solo encoladas (para decidir dormir) */
+    _Atomic bool shutdown;
+
+    /* Solo para dormir/despertar e idle, nunca en el push */
+    pthread_mutex_t wake_mutex;
+    pthread_cond_t wake_cond;
     pthread_cond_t idle_cond;
-    int active_threads;
-    bool shutdown;
 };
 
+/* Argumento de cada worker: pool + índice de su deque */
+typedef struct {
+    thread_pool_t *pool;
+    int id;
+} worker_arg_t;
+
+/**
+ * @brief Publica una tarea en un deque (solo el productor)
+ * @return true si había espacio
+ */
+static bool deque_push(work_deque_t *dq, void (*function)(void *), void *arg) {
+    size_t b = atomic_load_explicit(&dq->bottom, memory_order_relaxed);
+    size_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+
+    if (b - t >= DEQUE_CAPACITY) {
+        return false; /* Lleno */
+    }
+
+    dq->slots[b & (DEQUE_CAPACITY - 1)].function = function;
+    dq->slots[b & (DEQUE_CAPACITY - 1)].arg = arg;
+    atomic_store_explicit(&dq->bottom, b + 1, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief Toma una tarea del deque (dueño o ladrón, compiten con CAS)
+ * @return true si obtuvo una tarea
+ */
+static bool deque_take(work_deque_t *dq, task_slot_t *out) {
+    size_t t = atomic_load_explicit(&dq->top, memory_order_acquire);
+    size_t b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+
+    while (t < b) {
+        task_slot_t task = dq->slots[t & (DEQUE_CAPACITY - 1)];
+        if (atomic_compare_exchange_weak_explicit(&dq->top, &t, t + 1,
+                                                  memory_order_acq_rel,
+                                                  memory_order_acquire)) {
+            /* El productor no pudo sobrescribir la ranura: solo avanza
+               bottom cuando b - top < capacidad */
+            *out = task;
+            return true;
+        }
+        b = atomic_load_explicit(&dq->bottom, memory_order_acquire);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Busca trabajo: primero el deque propio, luego roba a los demás
+ */
+static bool find_task(thread_pool_t *pool, int id, task_slot_t *out) {
+    if (deque_take(&pool->deques[id], out)) {
+        return true;
+    }
+    for (int i = 1; i < pool->thread_count; i++) {
+        int victim = (id + i) % pool->thread_count;
+        if (deque_take(&pool->deques[victim], out)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 /**
  * @brief Función worker que ejecutan los hilos del pool
  */
 static void *worker_thread(void *arg) {
-    thread_pool_t *pool = (thread_pool_t *)arg;
-    
+    worker_arg_t *warg = (worker_arg_t *)arg;
+    thread_pool_t *pool = warg->pool;
+    int id = warg->id;
+    free(warg);
+
     while (1) {
-        pthread_mutex_lock(&pool->queue_mutex);
-        
-        /* Esperar a que haya tareas o se indique apagado */
-        while (pool->queue.count == 0 && !pool->shutdown) {
-            pthread_cond_wait(&pool->queue_cond, &pool->queue_mutex);
+        task_slot_t task;
+
+        if (find_task(pool, id, &task)) {
+            atomic_fetch_sub_explicit(&pool->queued, 1, memory_order_acq_rel);
+            task.function(task.arg);
+
+            /* Última tarea completada: despertar a thread_pool_wait */
+            if (atomic_fetch_sub_explicit(&pool->pending, 1,
+                                          memory_order_acq_rel) == 1) {
+                pthread_mutex_lock(&pool->wake_mutex);
+                pthread_cond_broadcast(&pool->idle_cond);
+                pthread_mutex_unlock(&pool->wake_mutex);
+            }
+            continue;
         }
-        
-        if (pool->shutdown && pool->queue.count == 0) {
-            pthread_mutex_unlock(&pool->queue_mutex);
+
+        if (atomic_load_explicit(&pool->shutdown, memory_order_acquire)) {
             break;
         }
-        
-        /* Obtener tarea de la cola */
-        task_node_t *task = pool->queue.head;
-        if (task) {
-            pool->queue.head = task->next;
-            if (pool->queue.head == NULL) {
-                pool->queue.tail = NULL;
-            }
-            pool->queue.count--;
-            pool->active_threads++;
-        }
-        
-        pthread_mutex_unlock(&pool->queue_mutex);
-        
-        /* Ejecutar tarea */
-        if (task) {
-            task->function(task->arg);
-            free(task);
-            
-            /* Decrementar contador de hilos activos */
-            pthread_mutex_lock(&pool->queue_mutex);
-            pool->active_threads--;
-            
-            /* Señalar si no hay tareas pendientes */
-            if (pool->active_threads == 0 && pool->queue.count == 0) {
-                pthread_cond_signal(&pool->idle_cond);
-            }
-            pthread_mutex_unlock(&pool->queue_mutex);
+
+        /* Sin trabajo encolado: dormir hasta que un push lo señale. El
+           productor incrementa queued antes de tomar el mutex para
+           señalar, así el re-chequeo bajo el mutex no pierde despertares */
+        pthread_mutex_lock(&pool->wake_mutex);
+        if (atomic_load_explicit(&pool->queued, memory_order_acquire) == 0 &&
+            !atomic_load_explicit(&pool->shutdown, memory_order_acquire)) {
+            pthread_cond_wait(&pool->wake_cond, &pool->wake_mutex);
         }
+        pthread_mutex_unlock(&pool->wake_mutex);
     }
-    
+
     return NULL;
 }
 
@@ -97,106 +168,128 @@ thread_pool_t *thread_pool_create(int num_threads) {
         LOG_ERROR("Invalid thread count: %d", num_threads);
         return NULL;
     }
-    
+
     thread_pool_t *pool = malloc(sizeof(thread_pool_t));
     if (!pool) {
         LOG_ERROR("Failed to allocate thread pool");
         return NULL;
     }
-    
-    /* Inicializar estructura */
+
     memset(pool, 0, sizeof(thread_pool_t));
     pool->thread_count = num_threads;
-    pool->shutdown = false;
-    
-    /* Inicializar mutex y variables de condición */
-    if (pthread_mutex_init(&pool->queue_mutex, NULL) != 0) {
-        LOG_ERROR("Failed to initialize queue mutex");
-        free(pool);
-        return NULL;
-    }
-    
-    if (pthread_cond_init(&pool->queue_cond, NULL) != 0) {
-        LOG_ERROR("Failed to initialize queue condition variable");
-        pthread_mutex_destroy(&pool->queue_mutex);
-        free(pool);
-        return NULL;
-    }
-    
-    if (pthread_cond_init(&pool->idle_cond, NULL) != 0) {
-        LOG_ERROR("Failed to initialize idle condition variable");
-        pthread_cond_destroy(&pool->queue_cond);
-        pthread_mutex_destroy(&pool->queue_mutex);
+    pool->next_deque = 0;
+    atomic_init(&pool->pending, 0);
+    atomic_init(&pool->queued, 0);
+    atomic_init(&pool->shutdown, false);
+
+    if (pthread_mutex_init(&pool->wake_mutex, NULL) != 0 ||
+        pthread_cond_init(&pool->wake_cond, NULL) != 0 ||
+        pthread_cond_init(&pool->idle_cond, NULL) != 0) {
+        LOG_ERROR("Failed to initialize pool synchronization");
         free(pool);
         return NULL;
     }
-    
-    /* Crear hilos */
+
+    /* Deques con su slab de tareas preasignado */
+    pool->deques = calloc(num_threads, sizeof(work_deque_t));
     pool->threads = malloc(sizeof(pthread_t) * num_threads);
-    if (!pool->threads) {
-        LOG_ERROR("Failed to allocate thread array");
-        pthread_cond_destroy(&pool->idle_cond);
-        pthread_cond_destroy(&pool->queue_cond);
-        pthread_mutex_destroy(&pool->queue_mutex);
+    if (!pool->deques || !pool->threads) {
+        LOG_ERROR("Failed to allocate pool structures");
+        free(pool->deques);
+        free(pool->threads);
         free(pool);
         return NULL;
     }
-    
+
     for (int i = 0; i < num_threads; i++) {
-        if (pthread_create(&pool->threads[i], NULL, worker_thread, pool) != 0) {
+        pool->deques[i].slots = malloc(DEQUE_CAPACITY * sizeof(task_slot_t));
+        if (!pool->deques[i].slots) {
+            LOG_ERROR("Failed to allocate task slab for deque %d", i);
+            for (int j = 0; j < i; j++) free(pool->deques[j].slots);
+            free(pool->deques);
+            free(pool->threads);
+            free(pool);
+            return NULL;
+        }
+        atomic_init(&pool->deques[i].top, 0);
+        atomic_init(&pool->deques[i].bottom, 0);
+    }
+
+    for (int i = 0; i < num_threads; i++) {
+        worker_arg_t *warg = malloc(sizeof(worker_arg_t));
+        if (!warg) {
+            LOG_ERROR("Failed to allocate worker argument %d", i);
+            pool->thread_count = i;
+            thread_pool_destroy(pool);
+            return NULL;
+        }
+        warg->pool = pool;
+        warg->id = i;
+        if (pthread_create(&pool->threads[i], NULL, worker_thread, warg) != 0) {
             LOG_ERROR("Failed to create thread %d", i);
+            free(warg);
             pool->thread_count = i;
             thread_pool_destroy(pool);
             return NULL;
         }
     }
-    
-    LOG_INFO("Thread pool created with %d threads", num_threads);
+
+    LOG_INFO("Thread pool created with %d threads (work-stealing)", num_threads);
     return pool;
 }
 
 /**
  * @brief Añade una tarea al pool de hilos
+ * @details Sin malloc por tarea: la tarea se copia a una ranura del slab.
+ *          Si todos los deques están llenos se ejecuta en línea.
  */
 int thread_pool_add_task(thread_pool_t *pool, void (*function)(void *), void *arg) {
     if (!pool || !function) {
         LOG_ERROR("Invalid parameters for thread_pool_add_task");
         return GSEA_ERROR_ARGS;
     }
-    
-    /* Crear nodo de tarea */
-    task_node_t *task = malloc(sizeof(task_node_t));
-    if (!task) {
-        LOG_ERROR("Failed to allocate task node");
-        return GSEA_ERROR_MEMORY;
-    }
-    
-    task->function = function;
-    task->arg = arg;
-    task->next = NULL;
-    
-    /* Añadir tarea a la cola */
-    pthread_mutex_lock(&pool->queue_mutex);
-    
-    if (pool->shutdown) {
-        pthread_mutex_unlock(&pool->queue_mutex);
-        free(task);
+
+    if (atomic_load_explicit(&pool->shutdown, memory_order_acquire)) {
         LOG_ERROR("Cannot add task to shutdown pool");
         return GSEA_ERROR_THREAD;
     }
-    
-    if (pool->queue.tail) {
-        pool->queue.tail->next = task;
-    } else {
-        pool->queue.head = task;
+
+    /* Contar antes de publicar: los workers re-chequean queued bajo el
+       mutex antes de dormir, así el despertar no se pierde */
+    atomic_fetch_add_explicit(&pool->pending, 1, memory_order_acq_rel);
+    atomic_fetch_add_explicit(&pool->queued, 1, memory_order_acq_rel);
+
+    /* Round-robin entre deques; si el elegido está lleno, probar el resto */
+    int start = pool->next_deque;
+    pool->next_deque = (start + 1) % pool->thread_count;
+
+    bool queued = false;
+    for (int i = 0; i < pool->thread_count; i++) {
+        int target = (start + i) % pool->thread_count;
+        if (deque_push(&pool->deques[target], function, arg)) {
+            queued = true;
+            break;
+        }
+    }
+
+    if (!queued) {
+        /* Todos llenos: ejecutar en línea en el hilo que encola */
+        atomic_fetch_sub_explicit(&pool->queued, 1, memory_order_acq_rel);
+        function(arg);
+        if (atomic_fetch_sub_explicit(&pool->pending, 1,
+                                      memory_order_acq_rel) == 1) {
+            pthread_mutex_lock(&pool->wake_mutex);
+            pthread_cond_broadcast(&pool->idle_cond);
+            pthread_mutex_unlock(&pool->wake_mutex);
+        }
+        return GSEA_SUCCESS;
     }
-    pool->queue.tail = task;
-    pool->queue.count++;
-    
-    /* Señalar a un hilo que hay trabajo */
-    pthread_cond_signal(&pool->queue_cond);
-    pthread_mutex_unlock(&pool->queue_mutex);
-    
+
+    /* Despertar a un hilo dormido */
+    pthread_mutex_lock(&pool->wake_mutex);
+    pthread_cond_signal(&pool->wake_cond);
+    pthread_mutex_unlock(&pool->wake_mutex);
+
     return GSEA_SUCCESS;
 }
 
@@ -205,16 +298,13 @@ int thread_pool_add_task(thread_pool_t *pool, void (*function)(void *), void *ar
  */
 void thread_pool_wait(thread_pool_t *pool) {
     if (!pool) return;
-    
-    pthread_mutex_lock(&pool->queue_mutex);
-    
-    /* Esperar mientras haya tareas pendientes o hilos activos */
-    while (pool->queue.count > 0 || pool->active_threads > 0) {
-        pthread_cond_wait(&pool->idle_cond, &pool->queue_mutex);
+
+    pthread_mutex_lock(&pool->wake_mutex);
+    while (atomic_load_explicit(&pool->pending, memory_order_acquire) > 0) {
+        pthread_cond_wait(&pool->idle_cond, &pool->wake_mutex);
     }
-    
-    pthread_mutex_unlock(&pool->queue_mutex);
-    
+    pthread_mutex_unlock(&pool->wake_mutex);
+
     LOG_INFO("All tasks completed");
 }
 
@@ -223,36 +313,30 @@ void thread_pool_wait(thread_pool_t *pool) {
  */
 void thread_pool_destroy(thread_pool_t *pool) {
     if (!pool) return;
-    
+
     LOG_INFO("Destroying thread pool");
-    
-    /* Señalar apagado */
-    pthread_mutex_lock(&pool->queue_mutex);
-    pool->shutdown = true;
-    pthread_cond_broadcast(&pool->queue_cond);
-    pthread_mutex_unlock(&pool->queue_mutex);
-    
-    /* Esperar a que terminen todos los hilos */
+
+    /* Señalar apagado y despertar a todos */
+    atomic_store_explicit(&pool->shutdown, true, memory_order_release);
+    pthread_mutex_lock(&pool->wake_mutex);
+    pthread_cond_broadcast(&pool->wake_cond);
+    pthread_mutex_unlock(&pool->wake_mutex);
+
     for (int i = 0; i < pool->thread_count; i++) {
         pthread_join(pool->threads[i], NULL);
     }
-    
-    /* Liberar tareas pendientes */
-    task_node_t *current = pool->queue.head;
-    while (current) {
-        task_node_t *next = current->next;
-        free(current);
-        current = next;
+
+    for (int i = 0; i < pool->thread_count; i++) {
+        free(pool->deques[i].slots);
     }
-    
-    /* Destruir sincronización */
+    free(pool->deques);
+
     pthread_cond_destroy(&pool->idle_cond);
-    pthread_cond_destroy(&pool->queue_cond);
-    pthread_mutex_destroy(&pool->queue_mutex);
-    
-    /* Liberar memoria */
+    pthread_cond_destroy(&pool->wake_cond);
+    pthread_mutex_destroy(&pool->wake_mutex);
+
     free(pool->threads);
     free(pool);
-    
+
     LOG_INFO("Thread pool destroyed");
-}
\ No newline at end of file
+}
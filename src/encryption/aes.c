@@ -24,16 +24,22 @@
  */
 
 #include "aes.h"
+#include "../utils/buffer_pool.h"
 #include "../common.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <time.h>
 
 #define AES_BLOCK_SIZE 16
 #define AES_KEY_SIZE   16
 #define AES_ROUNDS     10
 #define AES_ALG_ID     0x01  /* ID para identificar AES en archivo */
 
+/* Byte de modo en el header (tras el tamaño original) */
+#define AES_MODE_ECB   0x01
+#define AES_MODE_CTR   0x02
+
 /* ==================== TABLAS PRECOMPUTADAS GF(2^8) ==================== */
 static const uint8_t gf_mul_2[256] = {
     0x00, 0x02, 0x04, 0x06, 0x08, 0x0a, 0x0c, 0x0e, 0x10, 0x12, 0x14, 0x16, 0x18, 0x1a, 0x1c, 0x1e,
@@ -354,6 +360,152 @@ static void aes_decrypt_block(const uint8_t input[16], uint8_t output[16],
     add_round_key(output, round_keys[0]);
 }
 
+/* ==================== RUTA DE HARDWARE AES-NI ==================== */
+/* Detección en tiempo de ejecución: la ruta escalar de arriba queda como
+   fallback para CPUs sin las instrucciones AES */
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+static int aesni_available(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        cached = __builtin_cpu_supports("aes") ? 1 : 0;
+        if (cached) {
+            LOG_DEBUG("AES-NI hardware path enabled");
+        }
+    }
+    return cached;
+}
+
+/**
+ * @brief Encripta bloques contiguos con instrucciones AES-NI (in==out válido)
+ */
+__attribute__((target("aes,sse2")))
+static void aesni_encrypt_blocks(const uint8_t *input, uint8_t *output,
+                                 size_t num_blocks, uint8_t round_keys[11][16]) {
+    __m128i rk[11];
+    for (int i = 0; i <= AES_ROUNDS; i++) {
+        rk[i] = _mm_loadu_si128((const __m128i *)round_keys[i]);
+    }
+
+    for (size_t b = 0; b < num_blocks; b++) {
+        __m128i state = _mm_loadu_si128((const __m128i *)(input + b * AES_BLOCK_SIZE));
+        state = _mm_xor_si128(state, rk[0]);
+        for (int round = 1; round < AES_ROUNDS; round++) {
+            state = _mm_aesenc_si128(state, rk[round]);
+        }
+        state = _mm_aesenclast_si128(state, rk[AES_ROUNDS]);
+        _mm_storeu_si128((__m128i *)(output + b * AES_BLOCK_SIZE), state);
+    }
+}
+
+/**
+ * @brief Desencripta bloques contiguos con instrucciones AES-NI
+ */
+__attribute__((target("aes,sse2")))
+static void aesni_decrypt_blocks(const uint8_t *input, uint8_t *output,
+                                 size_t num_blocks, uint8_t round_keys[11][16]) {
+    /* Claves de desencriptación: orden inverso + InvMixColumns intermedias */
+    __m128i rk[11], dk[11];
+    for (int i = 0; i <= AES_ROUNDS; i++) {
+        rk[i] = _mm_loadu_si128((const __m128i *)round_keys[i]);
+    }
+    dk[0] = rk[AES_ROUNDS];
+    for (int i = 1; i < AES_ROUNDS; i++) {
+        dk[i] = _mm_aesimc_si128(rk[AES_ROUNDS - i]);
+    }
+    dk[AES_ROUNDS] = rk[0];
+
+    for (size_t b = 0; b < num_blocks; b++) {
+        __m128i state = _mm_loadu_si128((const __m128i *)(input + b * AES_BLOCK_SIZE));
+        state = _mm_xor_si128(state, dk[0]);
+        for (int round = 1; round < AES_ROUNDS; round++) {
+            state = _mm_aesdec_si128(state, dk[round]);
+        }
+        state = _mm_aesdeclast_si128(state, dk[AES_ROUNDS]);
+        _mm_storeu_si128((__m128i *)(output + b * AES_BLOCK_SIZE), state);
+    }
+}
+#else
+static int aesni_available(void) { return 0; }
+static void aesni_encrypt_blocks(const uint8_t *input, uint8_t *output,
+                                 size_t num_blocks, uint8_t round_keys[11][16]) {
+    (void)input; (void)output; (void)num_blocks; (void)round_keys;
+}
+static void aesni_decrypt_blocks(const uint8_t *input, uint8_t *output,
+                                 size_t num_blocks, uint8_t round_keys[11][16]) {
+    (void)input; (void)output; (void)num_blocks; (void)round_keys;
+}
+#endif
+
+/* ==================== MODO CTR ==================== */
+/* El keystream se genera encriptando bloques contador independientes, por lo
+   que CTR se pipelinea en hardware y es paralelizable por bloques */
+
+#define CTR_BATCH_BLOCKS 16  /* Bloques contador generados por lote */
+
+/**
+ * @brief Genera el nonce de 8 bytes para el modo CTR
+ */
+static void generate_ctr_nonce(uint8_t nonce[8]) {
+    FILE *urandom = fopen("/dev/urandom", "rb");
+    if (urandom) {
+        if (fread(nonce, 1, 8, urandom) == 8) {
+            fclose(urandom);
+            return;
+        }
+        fclose(urandom);
+    }
+    /* Fallback sin /dev/urandom: mezclar reloj y dirección de pila */
+    uintptr_t mix = (uintptr_t)nonce ^ (uintptr_t)clock();
+    for (int i = 0; i < 8; i++) {
+        nonce[i] = (uint8_t)(mix >> (i * 8)) ^ (uint8_t)(i * 151 + 17);
+    }
+}
+
+/**
+ * @brief Aplica el keystream CTR sobre data (encriptar == desencriptar)
+ */
+static void ctr_crypt(const uint8_t *input, uint8_t *output, size_t size,
+                      const uint8_t nonce[8], uint8_t round_keys[11][16]) {
+    uint8_t counters[CTR_BATCH_BLOCKS * AES_BLOCK_SIZE];
+    uint8_t keystream[CTR_BATCH_BLOCKS * AES_BLOCK_SIZE];
+    uint64_t counter = 0;
+    size_t pos = 0;
+
+    while (pos < size) {
+        size_t remaining_blocks = (size - pos + AES_BLOCK_SIZE - 1) / AES_BLOCK_SIZE;
+        size_t batch = MIN(remaining_blocks, (size_t)CTR_BATCH_BLOCKS);
+
+        /* Bloques contador: nonce(8) || contador big-endian(8) */
+        for (size_t b = 0; b < batch; b++) {
+            uint8_t *block = counters + b * AES_BLOCK_SIZE;
+            memcpy(block, nonce, 8);
+            uint64_t c = counter + b;
+            for (int i = 7; i >= 0; i--) {
+                block[8 + (7 - i)] = (uint8_t)(c >> (i * 8));
+            }
+        }
+
+        if (aesni_available()) {
+            aesni_encrypt_blocks(counters, keystream, batch, round_keys);
+        } else {
+            for (size_t b = 0; b < batch; b++) {
+                aes_encrypt_block(counters + b * AES_BLOCK_SIZE,
+                                  keystream + b * AES_BLOCK_SIZE, round_keys);
+            }
+        }
+
+        size_t chunk = MIN(batch * AES_BLOCK_SIZE, size - pos);
+        for (size_t i = 0; i < chunk; i++) {
+            output[pos + i] = input[pos + i] ^ keystream[i];
+        }
+
+        pos += chunk;
+        counter += batch;
+    }
+}
+
 /* ==================== ENCRYPT ==================== */
 int aes_encrypt(const file_buffer_t *input, file_buffer_t *output,
                 const uint8_t *key, size_t key_len) {
@@ -369,85 +521,188 @@ int aes_encrypt(const file_buffer_t *input, file_buffer_t *output,
     
     size_t padding = AES_BLOCK_SIZE - (input->size % AES_BLOCK_SIZE);
     size_t padded_size = input->size + padding;
-    
-    output->capacity = padded_size + 16; /* +16 para el header de tamaño */
-    output->data = malloc(output->capacity);
+
     output->size = 0;
-    
-    if (!output->data) {
-        LOG_ERROR("Memory allocation failed for encryption output");
+    /* +16 para el header de tamaño */
+    if (buffer_reserve(output, padded_size + 16) != GSEA_SUCCESS) {
         return GSEA_ERROR_MEMORY;
     }
-    
+
     /* Escribir tamaño original (8 bytes) */
     uint64_t orig_size = input->size;
     for (int i = 7; i >= 0; i--) {
         output->data[output->size++] = (orig_size >> (i * 8)) & 0xFF;
     }
-    
-    /* Procesar bloques completos */
-    for (size_t i = 0; i < input->size; i += AES_BLOCK_SIZE) {
-        uint8_t block[AES_BLOCK_SIZE];
-        size_t block_size = MIN(AES_BLOCK_SIZE, input->size - i);
-        
-        memcpy(block, input->data + i, block_size);
-        
-        /* Aplicar padding PKCS#7 al último bloque */
-        if (i + AES_BLOCK_SIZE >= input->size) {
-            for (size_t j = block_size; j < AES_BLOCK_SIZE; j++) {
-                block[j] = (uint8_t)padding;
-            }
+
+    /* Byte de modo */
+    output->data[output->size++] = AES_MODE_ECB;
+
+    /* Construir payload con padding PKCS#7 y encriptar in-place */
+    uint8_t *payload = output->data + output->size;
+    memcpy(payload, input->data, input->size);
+    for (size_t j = 0; j < padding; j++) {
+        payload[input->size + j] = (uint8_t)padding;
+    }
+
+    size_t num_blocks = padded_size / AES_BLOCK_SIZE;
+    if (aesni_available()) {
+        aesni_encrypt_blocks(payload, payload, num_blocks, round_keys);
+    } else {
+        for (size_t b = 0; b < num_blocks; b++) {
+            aes_encrypt_block(payload + b * AES_BLOCK_SIZE,
+                              payload + b * AES_BLOCK_SIZE, round_keys);
         }
-        
-        uint8_t out_block[AES_BLOCK_SIZE];
-        aes_encrypt_block(block, out_block, round_keys);
-        memcpy(output->data + output->size, out_block, AES_BLOCK_SIZE);
-        output->size += AES_BLOCK_SIZE;
     }
-    
+    output->size += padded_size;
+
     LOG_INFO("AES-128 encryption complete: %zu -> %zu bytes",
              input->size, output->size);
-    
+
+    return GSEA_SUCCESS;
+}
+
+/* ==================== ENCRYPT (CTR) ==================== */
+int aes_encrypt_ctr(const file_buffer_t *input, file_buffer_t *output,
+                    const uint8_t *key, size_t key_len) {
+    if (!input || !output || !key || key_len != AES_KEY_SIZE) {
+        LOG_ERROR("Invalid parameters for AES-CTR encryption");
+        return GSEA_ERROR_ARGS;
+    }
+
+    LOG_INFO("Starting AES-128-CTR encryption (%zu bytes)", input->size);
+
+    uint8_t round_keys[11][16];
+    key_expansion(key, round_keys);
+
+    /* Formato: [tamaño:8][modo:1][nonce:8][datos] — sin padding */
+    output->size = 0;
+    if (buffer_reserve(output, 8 + 1 + 8 + input->size) != GSEA_SUCCESS) {
+        return GSEA_ERROR_MEMORY;
+    }
+
+    uint64_t orig_size = input->size;
+    for (int i = 7; i >= 0; i--) {
+        output->data[output->size++] = (orig_size >> (i * 8)) & 0xFF;
+    }
+    output->data[output->size++] = AES_MODE_CTR;
+
+    uint8_t nonce[8];
+    generate_ctr_nonce(nonce);
+    memcpy(output->data + output->size, nonce, 8);
+    output->size += 8;
+
+    ctr_crypt(input->data, output->data + output->size, input->size,
+              nonce, round_keys);
+    output->size += input->size;
+
+    LOG_INFO("AES-128-CTR encryption complete: %zu -> %zu bytes",
+             input->size, output->size);
+
     return GSEA_SUCCESS;
 }
 
 /* Implementación de desencriptación AES-128 */
 int aes_decrypt(const file_buffer_t *input, file_buffer_t *output,
                 const uint8_t *key, size_t key_len) {
-    if (!input || !output || !key || key_len != AES_KEY_SIZE || input->size < 24) {
+    if (!input || !output || !key || key_len != AES_KEY_SIZE || input->size < 17) {
         LOG_ERROR("Invalid parameters for AES decryption");
         return GSEA_ERROR_ARGS;
     }
-    
+
     LOG_INFO("Starting AES-128 decryption");
-    
+
     /* Expandir clave */
     uint8_t round_keys[11][16];
     key_expansion(key, round_keys);
-    
+
     /* Leer tamaño original del header */
     uint64_t orig_size = 0;
     for (int i = 0; i < 8; i++) {
         orig_size = (orig_size << 8) | input->data[i];
     }
-    
+
+    /* Detectar formato: CTR, ECB con byte de modo, o ECB legado (sin modo).
+       El tamaño esperado de cada variante desambigua el byte en offset 8 */
+    size_t padded_size = orig_size + (AES_BLOCK_SIZE - (orig_size % AES_BLOCK_SIZE));
+    size_t payload_offset;
+    bool remove_padding = true;
+
+    /* Con orig%16==7 los layouts CTR y ECB legado miden lo mismo
+       (17+orig == 8+padded) y el primer byte de datos de un archivo
+       legado puede valer justo AES_MODE_CTR. El legado siempre termina
+       en un bloque con padding PKCS#7 válido, así que un trial-decrypt
+       del último bloque decide a favor del archivo viejo */
+    bool is_ctr = input->data[8] == AES_MODE_CTR &&
+                  input->size == 17 + orig_size;
+    if (is_ctr && input->size == 8 + padded_size) {
+        uint8_t last[AES_BLOCK_SIZE];
+        aes_decrypt_block(input->data + input->size - AES_BLOCK_SIZE, last,
+                          round_keys);
+        uint8_t pad = (uint8_t)(AES_BLOCK_SIZE - (orig_size % AES_BLOCK_SIZE));
+        bool legacy = true;
+        for (int j = 0; j < pad; j++) {
+            if (last[AES_BLOCK_SIZE - 1 - j] != pad) {
+                legacy = false;
+                break;
+            }
+        }
+        if (legacy) {
+            is_ctr = false;
+        }
+    }
+
+    if (is_ctr) {
+        /* CTR: [tamaño:8][modo:1][nonce:8][datos] */
+        const uint8_t *nonce = input->data + 9;
+
+        if (buffer_reserve(output, orig_size ? orig_size : 1)
+                != GSEA_SUCCESS) {
+            return GSEA_ERROR_MEMORY;
+        }
+
+        ctr_crypt(input->data + 17, output->data, orig_size, nonce, round_keys);
+        output->size = orig_size;
+
+        LOG_INFO("AES-128-CTR decryption complete: %zu -> %zu bytes",
+                 input->size, output->size);
+        return GSEA_SUCCESS;
+    } else if (input->data[8] == AES_MODE_ECB && input->size == 9 + padded_size) {
+        payload_offset = 9;
+    } else if (input->size == 8 + padded_size) {
+        /* Formato legado sin byte de modo */
+        payload_offset = 8;
+    } else if (orig_size % AES_BLOCK_SIZE == 0 && input->size == 8 + orig_size) {
+        /* Legado con tamaño múltiplo del bloque: el encriptador original
+           no emitía el bloque extra de padding */
+        payload_offset = 8;
+        remove_padding = false;
+    } else {
+        LOG_ERROR("Unrecognized AES header or corrupted data");
+        return GSEA_ERROR_ENCRYPTION;
+    }
+
     /* Inicializar buffer de salida */
-    output->capacity = orig_size + AES_BLOCK_SIZE;
-    output->data = malloc(output->capacity);
     output->size = 0;
-    
-    if (!output->data) {
-        LOG_ERROR("Memory allocation failed for decryption output");
+    if (buffer_reserve(output, orig_size + AES_BLOCK_SIZE) != GSEA_SUCCESS) {
         return GSEA_ERROR_MEMORY;
     }
-    
+
+    /* Bloques completos (todos menos el último) por la ruta de hardware */
+    size_t num_blocks = (input->size - payload_offset) / AES_BLOCK_SIZE;
+    if (aesni_available() && num_blocks > 1) {
+        aesni_decrypt_blocks(input->data + payload_offset, output->data,
+                             num_blocks - 1, round_keys);
+        output->size = (num_blocks - 1) * AES_BLOCK_SIZE;
+    }
+
     /* Desencriptar bloques */
-    for (size_t i = 8; i < input->size; i += AES_BLOCK_SIZE) {
+    for (size_t i = payload_offset + output->size; i < input->size; i += AES_BLOCK_SIZE) {
         uint8_t block[AES_BLOCK_SIZE];
         aes_decrypt_block(input->data + i, block, round_keys);
-        
-        /* Remover padding PKCS#7 del último bloque */
-        if (i + AES_BLOCK_SIZE >= input->size) {
+
+        /* Remover padding PKCS#7 del último bloque (el layout legado sin
+           bloque de padding se copia entero) */
+        if (remove_padding && i + AES_BLOCK_SIZE >= input->size) {
             uint8_t padding = block[AES_BLOCK_SIZE - 1];
             /* Validar padding PKCS#7: todos los bytes de padding deben tener el mismo valor */
             if (padding > 0 && padding <= AES_BLOCK_SIZE) {
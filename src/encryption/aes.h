@@ -20,7 +20,21 @@ int aes_encrypt(const file_buffer_t *input, file_buffer_t *output,
                 const uint8_t *key, size_t key_len);
 
 /**
- * @brief Desencripta datos usando AES-128 en modo ECB
+ * @brief Encripta datos usando AES-128 en modo CTR (sin padding)
+ * @details Los bloques contador son independientes, por lo que CTR se
+ *          pipelinea en hardware (AES-NI) y es paralelizable por bloques.
+ *          El nonce se guarda en el header; aes_decrypt() detecta el modo.
+ * @param input Buffer de entrada con datos sin encriptar
+ * @param output Buffer de salida para datos encriptados
+ * @param key Clave de encriptación (debe ser de 16 bytes)
+ * @param key_len Longitud de la clave (debe ser 16)
+ * @return GSEA_SUCCESS si la operación fue exitosa, código de error en caso contrario
+ */
+int aes_encrypt_ctr(const file_buffer_t *input, file_buffer_t *output,
+                    const uint8_t *key, size_t key_len);
+
+/**
+ * @brief Desencripta datos usando AES-128 (detecta modo ECB o CTR del header)
  * @param input Buffer de entrada con datos encriptados
  * @param output Buffer de salida para datos desencriptados
  * @param key Clave de desencriptación (debe ser de 16 bytes)
@@ -4,6 +4,7 @@
  */
 
 #include "chacha20.h"
+#include "../utils/buffer_pool.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -80,7 +81,78 @@ static void chacha20_block(const uint32_t input[16], uint8_t output[64]) {
     }
 }
 
-int chacha20_init(chacha20_ctx_t *ctx, const uint8_t key[CHACHA20_KEY_SIZE], 
+/* ==================== KERNEL SIMD MULTI-BLOQUE ==================== */
+/* Vectorización vertical: el lane i de cada registro contiene la palabra
+   correspondiente de los bloques 0..3; solo el contador difiere entre
+   bloques, así que 4 bloques de keystream se calculan en paralelo */
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define CHACHA20_HAVE_SSE2 1
+
+static int chacha20_sse2_available(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        cached = __builtin_cpu_supports("sse2") ? 1 : 0;
+    }
+    return cached;
+}
+
+#define VROTL32(v, n) \
+    _mm_or_si128(_mm_slli_epi32((v), (n)), _mm_srli_epi32((v), 32 - (n)))
+
+#define VQUARTERROUND(a, b, c, d) \
+    do { \
+        a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = VROTL32(d, 16); \
+        c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = VROTL32(b, 12); \
+        a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = VROTL32(d, 8); \
+        c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = VROTL32(b, 7); \
+    } while (0)
+
+/**
+ * @brief Genera 4 bloques consecutivos de keystream (256 bytes) con SSE2
+ */
+__attribute__((target("sse2")))
+static void chacha20_blocks4_sse2(const uint32_t input[16], uint8_t output[256]) {
+    __m128i x[16], orig[16];
+
+    for (int i = 0; i < 16; i++) {
+        orig[i] = _mm_set1_epi32((int)input[i]);
+    }
+    /* Contadores de los 4 bloques: counter + {0,1,2,3} */
+    orig[12] = _mm_add_epi32(orig[12], _mm_set_epi32(3, 2, 1, 0));
+
+    memcpy(x, orig, sizeof(x));
+
+    for (int i = 0; i < 10; i++) {
+        /* Rondas de columna */
+        VQUARTERROUND(x[0], x[4], x[8],  x[12]);
+        VQUARTERROUND(x[1], x[5], x[9],  x[13]);
+        VQUARTERROUND(x[2], x[6], x[10], x[14]);
+        VQUARTERROUND(x[3], x[7], x[11], x[15]);
+
+        /* Rondas de diagonal */
+        VQUARTERROUND(x[0], x[5], x[10], x[15]);
+        VQUARTERROUND(x[1], x[6], x[11], x[12]);
+        VQUARTERROUND(x[2], x[7], x[8],  x[13]);
+        VQUARTERROUND(x[3], x[4], x[9],  x[14]);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        x[i] = _mm_add_epi32(x[i], orig[i]);
+    }
+
+    /* Des-intercalar: el lane b de la palabra i va al bloque b */
+    for (int i = 0; i < 16; i++) {
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, x[i]);
+        for (int b = 0; b < 4; b++) {
+            store32_le(output + b * 64 + i * 4, lanes[b]);
+        }
+    }
+}
+#endif /* __x86_64__ || __i386__ */
+
+int chacha20_init(chacha20_ctx_t *ctx, const uint8_t key[CHACHA20_KEY_SIZE],
                   const uint8_t nonce[CHACHA20_NONCE_SIZE], uint32_t counter) {
     if (!ctx || !key || !nonce) {
         return CHACHA20_ERROR_INPUT;
@@ -122,8 +194,32 @@ int chacha20_crypt(chacha20_ctx_t *ctx, const uint8_t *input, uint8_t *output, s
     if (!ctx || !input || !output) {
         return CHACHA20_ERROR_INPUT;
     }
-    
-    for (size_t i = 0; i < length; i++) {
+
+    size_t i = 0;
+
+    /* Consumir primero el keystream parcial pendiente */
+    while (i < length && ctx->keystream_pos < CHACHA20_BLOCK_SIZE) {
+        output[i] = input[i] ^ ctx->keystream[ctx->keystream_pos++];
+        i++;
+    }
+
+#ifdef CHACHA20_HAVE_SSE2
+    /* Ruta SIMD: 4 bloques de keystream por iteración */
+    if (chacha20_sse2_available()) {
+        uint8_t keystream4[4 * CHACHA20_BLOCK_SIZE];
+        while (length - i >= sizeof(keystream4) &&
+               ctx->state[12] <= UINT32_MAX - 4) {
+            chacha20_blocks4_sse2(ctx->state, keystream4);
+            for (size_t j = 0; j < sizeof(keystream4); j++) {
+                output[i + j] = input[i + j] ^ keystream4[j];
+            }
+            ctx->state[12] += 4;
+            i += sizeof(keystream4);
+        }
+    }
+#endif
+
+    for (; i < length; i++) {
         /* Generar nuevo bloque de keystream si es necesario */
         if (ctx->keystream_pos >= CHACHA20_BLOCK_SIZE) {
             chacha20_block(ctx->state, ctx->keystream);
@@ -243,13 +339,9 @@ int chacha20_encrypt(const file_buffer_t *input, file_buffer_t *output,
     
     /* Formato de salida: [nonce:12][tamaño_original:8][datos_encriptados] */
     size_t total_size = CHACHA20_NONCE_SIZE + 8 + input->size;
-    output->data = malloc(total_size);
-    if (!output->data) {
-        LOG_ERROR("Memory allocation failed");
+    if (buffer_reserve(output, total_size) != GSEA_SUCCESS) {
         return GSEA_ERROR_MEMORY;
     }
-    
-    output->capacity = total_size;
     output->size = total_size;
     
     /* Escribir nonce */
@@ -329,13 +421,9 @@ int chacha20_decrypt(const file_buffer_t *input, file_buffer_t *output,
     }
     
     /* Asignar buffer de salida */
-    output->data = malloc(orig_size);
-    if (!output->data) {
-        LOG_ERROR("Memory allocation failed");
+    if (buffer_reserve(output, orig_size) != GSEA_SUCCESS) {
         return GSEA_ERROR_MEMORY;
     }
-    
-    output->capacity = orig_size;
     output->size = orig_size;
     
     /* Inicializar ChaCha20 */
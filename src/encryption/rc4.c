@@ -4,6 +4,7 @@
  */
 
  #include "rc4.h"
+#include "../utils/buffer_pool.h"
  #include "../common.h"
  #include <stdlib.h>
  #include <string.h>
@@ -162,14 +163,10 @@
      
      /* Formato de salida: [tamaño_original:8][datos_encriptados] */
      size_t total_size = 8 + input->size;
-     output->data = malloc(total_size);
-     if (!output->data) {
-         LOG_ERROR("Memory allocation failed");
+     if (buffer_reserve(output, total_size) != GSEA_SUCCESS) {
          return GSEA_ERROR_MEMORY;
      }
-     
      output->size = total_size;
-     output->capacity = total_size;
      
      /* Escribir tamaño original (8 bytes, little-endian) */
      uint64_t orig_size = input->size;
@@ -241,14 +238,10 @@
      }
      
      /* Asignar buffer de salida */
-     output->data = malloc(orig_size);
-     if (!output->data) {
-         LOG_ERROR("Memory allocation failed");
+     if (buffer_reserve(output, orig_size) != GSEA_SUCCESS) {
          return GSEA_ERROR_MEMORY;
      }
-     
      output->size = orig_size;
-     output->capacity = orig_size;
      
      /* Inicializar RC4 */
      rc4_ctx_t ctx;
@@ -4,6 +4,7 @@
  */
 
 #include "salsa20.h"
+#include "../utils/buffer_pool.h"
 #include <string.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -99,7 +100,85 @@ static void salsa20_block(const uint32_t input[16], uint8_t output[64]) {
     }
 }
 
-int salsa20_init(salsa20_ctx_t *ctx, const uint8_t key[SALSA20_KEY_SIZE], 
+/* ==================== KERNEL SIMD MULTI-BLOQUE ==================== */
+/* Vectorización vertical (igual que en chacha20.c): el lane i de cada
+   registro contiene la palabra correspondiente de los bloques 0..3 */
+#if defined(__x86_64__) || defined(__i386__)
+#include <emmintrin.h>
+#define SALSA20_HAVE_SSE2 1
+
+static int salsa20_sse2_available(void) {
+    static int cached = -1;
+    if (cached < 0) {
+        cached = __builtin_cpu_supports("sse2") ? 1 : 0;
+    }
+    return cached;
+}
+
+#define VROTL32(v, n) \
+    _mm_or_si128(_mm_slli_epi32((v), (n)), _mm_srli_epi32((v), 32 - (n)))
+
+#define VSALSA_QR(y0, y1, y2, y3) \
+    do { \
+        y1 = _mm_xor_si128(y1, VROTL32(_mm_add_epi32(y0, y3), 7)); \
+        y2 = _mm_xor_si128(y2, VROTL32(_mm_add_epi32(y1, y0), 9)); \
+        y3 = _mm_xor_si128(y3, VROTL32(_mm_add_epi32(y2, y1), 13)); \
+        y0 = _mm_xor_si128(y0, VROTL32(_mm_add_epi32(y3, y2), 18)); \
+    } while (0)
+
+/**
+ * @brief Genera 4 bloques consecutivos de keystream (256 bytes) con SSE2
+ */
+__attribute__((target("sse2")))
+static void salsa20_blocks4_sse2(const uint32_t input[16], uint64_t counter,
+                                 uint8_t output[256]) {
+    __m128i x[16], orig[16];
+
+    for (int i = 0; i < 16; i++) {
+        orig[i] = _mm_set1_epi32((int)input[i]);
+    }
+
+    /* Contador de 64 bits (palabras 8 y 9): counter + {0,1,2,3} por lane */
+    uint32_t lo[4], hi[4];
+    for (int b = 0; b < 4; b++) {
+        uint64_t c = counter + (uint64_t)b;
+        lo[b] = (uint32_t)(c & 0xFFFFFFFF);
+        hi[b] = (uint32_t)(c >> 32);
+    }
+    orig[8] = _mm_set_epi32((int)lo[3], (int)lo[2], (int)lo[1], (int)lo[0]);
+    orig[9] = _mm_set_epi32((int)hi[3], (int)hi[2], (int)hi[1], (int)hi[0]);
+
+    memcpy(x, orig, sizeof(x));
+
+    /* 20 rondas = 10 double rounds (columna + fila) */
+    for (int i = 0; i < 10; i++) {
+        VSALSA_QR(x[0],  x[4],  x[8],  x[12]);
+        VSALSA_QR(x[5],  x[9],  x[13], x[1]);
+        VSALSA_QR(x[10], x[14], x[2],  x[6]);
+        VSALSA_QR(x[15], x[3],  x[7],  x[11]);
+
+        VSALSA_QR(x[0],  x[1],  x[2],  x[3]);
+        VSALSA_QR(x[5],  x[6],  x[7],  x[4]);
+        VSALSA_QR(x[10], x[11], x[8],  x[9]);
+        VSALSA_QR(x[15], x[12], x[13], x[14]);
+    }
+
+    for (int i = 0; i < 16; i++) {
+        x[i] = _mm_add_epi32(x[i], orig[i]);
+    }
+
+    /* Des-intercalar: el lane b de la palabra i va al bloque b */
+    for (int i = 0; i < 16; i++) {
+        uint32_t lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, x[i]);
+        for (int b = 0; b < 4; b++) {
+            store32_le(output + b * 64 + i * 4, lanes[b]);
+        }
+    }
+}
+#endif /* __x86_64__ || __i386__ */
+
+int salsa20_init(salsa20_ctx_t *ctx, const uint8_t key[SALSA20_KEY_SIZE],
                  const uint8_t nonce[SALSA20_NONCE_SIZE], uint64_t counter) {
     if (!ctx || !key || !nonce) {
         return SALSA20_ERROR_INPUT;
@@ -147,8 +226,35 @@ int salsa20_crypt(salsa20_ctx_t *ctx, const uint8_t *input, uint8_t *output, siz
     if (!ctx || !input || !output) {
         return SALSA20_ERROR_INPUT;
     }
-    
-    for (size_t i = 0; i < length; i++) {
+
+    size_t i = 0;
+
+    /* Consumir primero el keystream parcial pendiente del bloque anterior */
+    while (i < length && ctx->keystream_pos < SALSA20_BLOCK_SIZE) {
+        output[i] = input[i] ^ ctx->keystream[ctx->keystream_pos];
+        ctx->keystream_pos++;
+        i++;
+    }
+
+#ifdef SALSA20_HAVE_SSE2
+    /* Ruta rápida: generar 4 bloques de keystream por iteración con SSE2 */
+    if (salsa20_sse2_available()) {
+        uint8_t keystream4[4 * SALSA20_BLOCK_SIZE];
+        while (length - i >= sizeof(keystream4) &&
+               ctx->counter <= UINT64_MAX - 4) {
+            salsa20_blocks4_sse2(ctx->state, ctx->counter, keystream4);
+            for (size_t j = 0; j < sizeof(keystream4); j++) {
+                output[i + j] = input[i + j] ^ keystream4[j];
+            }
+            ctx->counter += 4;
+            ctx->state[8] = (uint32_t)(ctx->counter & 0xFFFFFFFF);
+            ctx->state[9] = (uint32_t)(ctx->counter >> 32);
+            i += sizeof(keystream4);
+        }
+    }
+#endif
+
+    for (; i < length; i++) {
         /* Generar nuevo bloque de keystream si es necesario */
         if (ctx->keystream_pos >= SALSA20_BLOCK_SIZE) {
             salsa20_block(ctx->state, ctx->keystream);
@@ -260,8 +366,7 @@ int salsa20_encrypt(const file_buffer_t *input, file_buffer_t *output,
     /* Calcular tamaño de salida: nonce (8) + tamaño_original (8) + datos_encriptados */
     size_t output_size = SALSA20_NONCE_SIZE + sizeof(uint64_t) + input->size;
     
-    output->data = malloc(output_size);
-    if (!output->data) {
+    if (buffer_reserve(output, output_size) != GSEA_SUCCESS) {
         return GSEA_ERROR_MEMORY;
     }
     output->size = output_size;
@@ -335,8 +440,7 @@ int salsa20_decrypt(const file_buffer_t *input, file_buffer_t *output,
     }
 
     /* Reservar memoria para salida */
-    output->data = malloc(orig_size);
-    if (!output->data) {
+    if (buffer_reserve(output, orig_size) != GSEA_SUCCESS) {
         return GSEA_ERROR_MEMORY;
     }
     output->size = orig_size;
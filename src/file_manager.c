@@ -6,8 +6,12 @@
 
 #include "file_manager.h"
 #include "common.h"
+#include "io_engine.h"
+#include "utils/arena.h"
+#include "utils/buffer_pool.h"
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/mman.h>
 #include <fcntl.h>
 #include <unistd.h>
 #include <dirent.h>
@@ -15,6 +19,82 @@
 #include <string.h>
 #include <errno.h>
 #include <stdio.h>
+#include <sys/syscall.h>
+
+/* ==============================
+ * Política de durabilidad
+ * ============================== */
+
+/* Política vigente: se fija una vez al arrancar, los workers solo leen */
+static fsync_policy_t fsync_policy = FSYNC_PER_FILE;
+
+/**
+ * @brief Fija la política de sincronización a disco de write_file
+ */
+void file_manager_set_fsync_policy(fsync_policy_t policy) {
+    fsync_policy = policy;
+}
+
+/**
+ * @brief Consulta la política de sincronización vigente
+ */
+fsync_policy_t file_manager_get_fsync_policy(void) {
+    return fsync_policy;
+}
+
+/* ==============================
+ * Control de caché de páginas
+ * ============================== */
+
+/* Modo streaming: los datos se procesan una sola vez de principio a fin,
+   así que no hay reuso que perder; se avisa al kernel con posix_fadvise
+   para no desalojar la caché de otras cargas en el mismo host */
+static bool streaming_io = false;
+
+/**
+ * @brief Activa o desactiva el modo de E/S streaming (fadvise)
+ */
+void file_manager_set_streaming_io(bool enabled) {
+    streaming_io = enabled;
+    if (enabled) {
+        LOG_DEBUG("Streaming I/O mode enabled (page cache advice)");
+    }
+}
+
+/**
+ * @brief Consulta si el modo de E/S streaming está activo
+ */
+bool file_manager_streaming_io(void) {
+    return streaming_io;
+}
+
+/**
+ * @brief Sincroniza el sistema de archivos que contiene path
+ * @details syscall cruda: syncfs(2) no está expuesto por _DEFAULT_SOURCE
+ */
+int file_manager_sync_output(const char *path) {
+    if (!path) {
+        LOG_ERROR("Invalid path for file_manager_sync_output");
+        return GSEA_ERROR_ARGS;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open '%s' for sync: %s", path, strerror(errno));
+        return GSEA_ERROR_FILE;
+    }
+
+    if (syscall(SYS_syncfs, fd) < 0) {
+        LOG_ERROR("Failed to sync filesystem of '%s': %s", path,
+                  strerror(errno));
+        close(fd);
+        return GSEA_ERROR_FILE;
+    }
+
+    close(fd);
+    LOG_DEBUG("Synced filesystem containing '%s'", path);
+    return GSEA_SUCCESS;
+}
 
 /**
  * @brief Lee un archivo completo en memoria usando syscalls
@@ -31,7 +111,12 @@ int read_file(const char *path, file_buffer_t *buffer) {
         LOG_ERROR("Failed to open file '%s': %s", path, strerror(errno));
         return GSEA_ERROR_FILE;
     }
-    
+
+    /* Lectura de una sola pasada: readahead agresivo */
+    if (streaming_io) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
     /* Obtener tamaño del archivo */
     struct stat st;
     if (fstat(fd, &st) < 0) {
@@ -39,20 +124,30 @@ int read_file(const char *path, file_buffer_t *buffer) {
         close(fd);
         return GSEA_ERROR_FILE;
     }
-    
+
     size_t file_size = st.st_size;
-    
-    /* Asignar buffer */
-    buffer->capacity = file_size + 1;
-    buffer->data = malloc(buffer->capacity);
+
+    /* Asignar buffer (reutiliza almacenamiento previo si alcanza) */
     buffer->size = 0;
-    
-    if (!buffer->data) {
-        LOG_ERROR("Memory allocation failed for file buffer");
+    buffer->mapped = false;
+    if (buffer_reserve(buffer, file_size + 1) != GSEA_SUCCESS) {
         close(fd);
         return GSEA_ERROR_MEMORY;
     }
     
+    /* Ruta io_uring: todo el archivo en lecturas por lotes con offsets
+       explícitos; si falla, la ruta POSIX parte de la posición 0 intacta */
+    if (io_engine_active() &&
+        io_engine_read(fd, buffer->data, file_size) == GSEA_SUCCESS) {
+        buffer->size = file_size;
+        if (streaming_io) {
+            posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        }
+        close(fd);
+        LOG_DEBUG("Read %zu bytes from '%s' (io_uring)", buffer->size, path);
+        return GSEA_SUCCESS;
+    }
+
     /* Leer archivo en bloques usando syscall read */
     ssize_t bytes_read;
     while ((bytes_read = read(fd, buffer->data + buffer->size, 
@@ -80,13 +175,85 @@ int read_file(const char *path, file_buffer_t *buffer) {
         return GSEA_ERROR_FILE;
     }
     
+    /* Los datos ya viven en el buffer: soltar las páginas de caché antes
+       de cerrar para no desplazar otras cargas */
+    if (streaming_io) {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+
     /* Cerrar archivo con syscall close */
     close(fd);
-    
+
     LOG_DEBUG("Read %zu bytes from '%s'", buffer->size, path);
     return GSEA_SUCCESS;
 }
 
+/**
+ * @brief Mapea un archivo completo en memoria de solo lectura usando mmap
+ * @details Alternativa zero-copy a read_file(): el pipeline consume la vista
+ *          mapeada directamente sin copiar los datos a un buffer intermedio.
+ *          El buffer resultante debe liberarse con free_buffer(), que detecta
+ *          el mapeo y usa munmap en lugar de free.
+ */
+int map_file(const char *path, file_buffer_t *buffer) {
+    if (!path || !buffer) {
+        LOG_ERROR("Invalid parameters for map_file");
+        return GSEA_ERROR_ARGS;
+    }
+
+    /* En modo streaming el mapeo juega en contra: tras munmap las páginas
+       del archivo quedan en la caché desplazando otras cargas. Leer con
+       read_file deja una copia en heap y permite soltarlas con fadvise */
+    if (streaming_io) {
+        return read_file(path, buffer);
+    }
+
+    /* Abrir archivo con syscall open */
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        LOG_ERROR("Failed to open file '%s': %s", path, strerror(errno));
+        return GSEA_ERROR_FILE;
+    }
+
+    /* Obtener tamaño del archivo */
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        LOG_ERROR("Failed to stat file '%s': %s", path, strerror(errno));
+        close(fd);
+        return GSEA_ERROR_FILE;
+    }
+
+    size_t file_size = st.st_size;
+
+    /* mmap no admite mapeos de longitud cero: delegar en read_file */
+    if (file_size == 0) {
+        close(fd);
+        return read_file(path, buffer);
+    }
+
+    /* Mapear el archivo de solo lectura */
+    void *addr = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) {
+        LOG_ERROR("Failed to mmap file '%s': %s", path, strerror(errno));
+        close(fd);
+        return GSEA_ERROR_FILE;
+    }
+
+    /* Lectura secuencial: pedir readahead agresivo al kernel */
+    posix_madvise(addr, file_size, POSIX_MADV_SEQUENTIAL);
+
+    /* El mapeo persiste tras cerrar el descriptor */
+    close(fd);
+
+    buffer->data = (uint8_t *)addr;
+    buffer->size = file_size;
+    buffer->capacity = file_size;
+    buffer->mapped = true;
+
+    LOG_DEBUG("Mapped %zu bytes from '%s'", buffer->size, path);
+    return GSEA_SUCCESS;
+}
+
 /**
  * @brief Escribe un buffer en un archivo usando syscalls
  */
@@ -103,8 +270,15 @@ int write_file(const char *path, const file_buffer_t *buffer) {
         return GSEA_ERROR_FILE;
     }
     
+    /* Ruta io_uring: escrituras por lotes con offsets explícitos. Una
+       escritura parcial no estorba al fallback: la ruta POSIX reescribe
+       los mismos bytes desde el inicio */
+    bool uring_done = io_engine_active() &&
+                      io_engine_write(fd, buffer->data, buffer->size) ==
+                          GSEA_SUCCESS;
+
     /* Escribir datos en bloques usando syscall write */
-    size_t bytes_written = 0;
+    size_t bytes_written = uring_done ? buffer->size : 0;
     while (bytes_written < buffer->size) {
         ssize_t result = write(fd, buffer->data + bytes_written,
                               buffer->size - bytes_written);
@@ -116,11 +290,21 @@ int write_file(const char *path, const file_buffer_t *buffer) {
         bytes_written += result;
     }
     
-    /* Sincronizar datos al disco */
-    if (fsync(fd) < 0) {
+    /* Sincronizar datos al disco según la política vigente */
+    if (fsync_policy == FSYNC_PER_FILE && fsync(fd) < 0) {
         LOG_ERROR("Failed to sync file '%s': %s", path, strerror(errno));
     }
-    
+
+    /* Soltar las páginas escritas: DONTNEED solo desaloja páginas limpias,
+       así que sin fsync previo hay que forzar el writeback primero */
+    if (streaming_io) {
+        if (fsync_policy != FSYNC_PER_FILE && fdatasync(fd) < 0) {
+            LOG_DEBUG("fdatasync before cache drop failed for '%s': %s",
+                      path, strerror(errno));
+        }
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+
     /* Cerrar archivo con syscall close */
     close(fd);
     
@@ -133,7 +317,12 @@ int write_file(const char *path, const file_buffer_t *buffer) {
  */
 void free_buffer(file_buffer_t *buffer) {
     if (buffer && buffer->data) {
-        free(buffer->data);
+        if (buffer->mapped) {
+            munmap(buffer->data, buffer->capacity);
+            buffer->mapped = false;
+        } else {
+            free(buffer->data);
+        }
         buffer->data = NULL;
         buffer->size = 0;
         buffer->capacity = 0;
@@ -188,98 +377,74 @@ int create_directory(const char *path) {
 }
 
 /**
- * @brief Lista archivos en un directorio
+ * @brief Lista archivos en un directorio (una sola pasada, sobre arena)
+ * @details Las rutas se copian con su longitud exacta en la arena del
+ *          trabajo y el array de punteros crece por duplicación dentro de
+ *          la misma arena; todo se libera en bloque con arena_destroy.
  */
-int list_directory(const char *path, char ***files, int *count) {
-    if (!path || !files || !count) {
+int list_directory(const char *path, arena_t *arena, char ***files, int *count) {
+    if (!path || !arena || !files || !count) {
         LOG_ERROR("Invalid parameters for list_directory");
         return GSEA_ERROR_ARGS;
     }
-    
+
     /* Abrir directorio con syscall opendir */
     DIR *dir = opendir(path);
     if (!dir) {
         LOG_ERROR("Failed to open directory '%s': %s", path, strerror(errno));
         return GSEA_ERROR_FILE;
     }
-    
-    /* Contar archivos primero */
-    *count = 0;
+
+    int capacity = 64;
+    int found = 0;
+    char **list = arena_alloc(arena, capacity * sizeof(char *));
+    if (!list) {
+        closedir(dir);
+        return GSEA_ERROR_MEMORY;
+    }
+
     struct dirent *entry;
     while ((entry = readdir(dir)) != NULL) {
         /* Ignorar . y .. */
         if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
             continue;
         }
-        
+
         /* Construir ruta completa */
         char full_path[MAX_PATH_LENGTH];
         snprintf(full_path, sizeof(full_path), "%s/%s", path, entry->d_name);
-        
-        /* Solo contar archivos regulares */
-        if (is_regular_file(full_path)) {
-            (*count)++;
-        }
-    }
-    
-    /* Asignar array de strings */
-    *files = malloc(sizeof(char *) * (*count));
-    if (!*files) {
-        LOG_ERROR("Memory allocation failed for file list");
-        closedir(dir);
-        return GSEA_ERROR_MEMORY;
-    }
-    
-    /* Reiniciar lectura del directorio */
-    rewinddir(dir);
-    
-    /* Llenar array con nombres de archivos */
-    int i = 0;
-    while ((entry = readdir(dir)) != NULL && i < *count) {
-        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+
+        /* Solo listar archivos regulares */
+        if (!is_regular_file(full_path)) {
             continue;
         }
-        
-        char full_path[MAX_PATH_LENGTH];
-        snprintf(full_path, sizeof(full_path), "%s/%s", path, entry->d_name);
-        
-        if (is_regular_file(full_path)) {
-            (*files)[i] = malloc(MAX_PATH_LENGTH);
-            if (!(*files)[i]) {
-                LOG_ERROR("Memory allocation failed for filename");
-                /* Liberar memoria asignada previamente */
-                for (int j = 0; j < i; j++) {
-                    free((*files)[j]);
-                }
-                free(*files);
+
+        if (found == capacity) {
+            /* Duplicar el array: la copia vieja queda en la arena, un
+               desperdicio acotado a cambio de liberar todo en bloque */
+            char **grown = arena_alloc(arena, 2 * capacity * sizeof(char *));
+            if (!grown) {
                 closedir(dir);
                 return GSEA_ERROR_MEMORY;
             }
-            size_t len = strlen(full_path);
-            size_t copy_len = (len < MAX_PATH_LENGTH - 1) ? len : MAX_PATH_LENGTH - 1;
-            memcpy((*files)[i], full_path, copy_len);
-            (*files)[i][copy_len] = '\0';
-            i++;
+            memcpy(grown, list, found * sizeof(char *));
+            list = grown;
+            capacity *= 2;
         }
+
+        list[found] = arena_strdup(arena, full_path);
+        if (!list[found]) {
+            closedir(dir);
+            return GSEA_ERROR_MEMORY;
+        }
+        found++;
     }
-    
+
     /* Cerrar directorio con syscall closedir */
     closedir(dir);
-    
-    LOG_DEBUG("Found %d files in directory '%s'", *count, path);
-    return GSEA_SUCCESS;
-}
 
-/**
- * @brief Libera la lista de archivos retornada por list_directory
- */
-void free_file_list(char **files, int count) {
-    if (files) {
-        for (int i = 0; i < count; i++) {
-            if (files[i]) {
-                free(files[i]);
-            }
-        }
-        free(files);
-    }
+    *files = list;
+    *count = found;
+    LOG_DEBUG("Found %d files in directory '%s'", found, path);
+    return GSEA_SUCCESS;
 }
\ No newline at end of file
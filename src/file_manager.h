@@ -7,6 +7,42 @@
 #define FILE_MANAGER_H
 
 #include "common.h"
+#include "utils/arena.h"
+
+/**
+ * @brief Fija la política de sincronización a disco de write_file
+ * @param policy FSYNC_PER_FILE, FSYNC_END o FSYNC_NONE
+ */
+void file_manager_set_fsync_policy(fsync_policy_t policy);
+
+/**
+ * @brief Consulta la política de sincronización vigente
+ */
+fsync_policy_t file_manager_get_fsync_policy(void);
+
+/**
+ * @brief Activa o desactiva el modo de E/S streaming
+ * @details Avisa al kernel con posix_fadvise: readahead secuencial en las
+ *          entradas y desalojo (DONTNEED) de los rangos ya consumidos y de
+ *          las salidas escritas, para no contaminar la caché de páginas de
+ *          otras cargas del host en trabajos grandes de una sola pasada.
+ * @param enabled true para activar
+ */
+void file_manager_set_streaming_io(bool enabled);
+
+/**
+ * @brief Consulta si el modo de E/S streaming está activo
+ */
+bool file_manager_streaming_io(void);
+
+/**
+ * @brief Sincroniza el sistema de archivos que contiene path
+ * @details Usado por la política FSYNC_END: un solo syncfs al final del
+ *          trabajo en lugar de un fsync por archivo
+ * @param path Archivo o directorio de salida del trabajo
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int file_manager_sync_output(const char *path);
 
 /**
  * @brief Lee un archivo completo en un buffer
@@ -16,6 +52,14 @@
  */
 int read_file(const char *path, file_buffer_t *buffer);
 
+/**
+ * @brief Mapea un archivo completo en memoria (solo lectura, zero-copy)
+ * @param path Ruta del archivo a mapear
+ * @param buffer Buffer que recibirá la vista mmap de solo lectura
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int map_file(const char *path, file_buffer_t *buffer);
+
 /**
  * @brief Escribe un buffer en un archivo
  * @param path Ruta del archivo de destino
@@ -52,19 +96,14 @@ bool is_regular_file(const char *path);
 int create_directory(const char *path);
 
 /**
- * @brief Lista todos los archivos en un directorio
+ * @brief Lista todos los archivos en un directorio (una sola pasada)
  * @param path Ruta del directorio
- * @param files [out] Array de strings con rutas de archivos
+ * @param arena Arena del trabajo donde viven las rutas y el array
+ * @param files [out] Array de strings con rutas de archivos (en la arena)
  * @param count [out] Número de archivos encontrados
  * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ * @note No hay liberación individual: arena_destroy libera todo en bloque
  */
-int list_directory(const char *path, char ***files, int *count);
-
-/**
- * @brief Libera la lista de archivos retornada por list_directory
- * @param files Array de strings a liberar
- * @param count Número de elementos en el array
- */
-void free_file_list(char **files, int count);
+int list_directory(const char *path, arena_t *arena, char ***files, int *count);
 
 #endif /* FILE_MANAGER_H */
\ No newline at end of file
@@ -0,0 +1,342 @@
+/**
+ * @file io_engine.c
+ * @brief Motor de E/S por lotes sobre io_uring (syscalls crudas)
+ * @details Este árbol no depende de liburing: los anillos se montan a mano
+ *          con io_uring_setup(2) + mmap y se operan con io_uring_enter(2).
+ *          Cada hilo tiene su propio anillo (sin bloqueos entre workers);
+ *          los anillos viven hasta el final del proceso, igual que los
+ *          hilos del pool. Las transferencias se parten en segmentos y se
+ *          envían en lotes: una sola syscall cubre hasta IO_QUEUE_DEPTH
+ *          operaciones, frente a una syscall por bloque de la ruta POSIX.
+ */
+
+#include "io_engine.h"
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* Profundidad del anillo de envío (potencia de dos) */
+#define IO_QUEUE_DEPTH 32u
+
+/* Tamaño máximo de cada segmento encolado */
+#define IO_SEGMENT_SIZE (1u * 1024u * 1024u)
+
+/* ==============================
+ * Estado global del motor
+ * ============================== */
+
+/* Habilitado por configuración (--io-engine uring) */
+static _Atomic bool engine_enabled = false;
+
+/* Soporte del kernel: 0 = sin probar, 1 = disponible, -1 = no disponible */
+static _Atomic int kernel_support = 0;
+
+/* ==============================
+ * Anillo por hilo
+ * ============================== */
+
+typedef struct {
+    int ring_fd;
+    unsigned sq_entries;
+    unsigned *sq_head;
+    unsigned *sq_tail;
+    unsigned *sq_mask;
+    unsigned *sq_array;
+    unsigned *cq_head;
+    unsigned *cq_tail;
+    unsigned *cq_mask;
+    struct io_uring_sqe *sqes;
+    struct io_uring_cqe *cqes;
+    bool ready;
+    bool failed;
+} io_ring_t;
+
+static _Thread_local io_ring_t tls_ring;
+
+/* Segmento pendiente de una transferencia */
+typedef struct {
+    uint64_t off;
+    uint32_t len;
+} io_segment_t;
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params *params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete,
+                              unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete,
+                        flags, NULL, 0);
+}
+
+/**
+ * @brief Monta el anillo del hilo actual (setup + mmap de SQ, CQ y SQEs)
+ * @return true si el anillo quedó operativo
+ */
+static bool ring_init(io_ring_t *ring) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    ring->ring_fd = sys_io_uring_setup(IO_QUEUE_DEPTH, &params);
+    if (ring->ring_fd < 0) {
+        return false;
+    }
+
+    size_t sq_len = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_len = params.cq_off.cqes +
+                    params.cq_entries * sizeof(struct io_uring_cqe);
+
+    /* Kernels modernos exponen SQ y CQ en un solo mapeo */
+    void *sq_ptr;
+    void *cq_ptr;
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        size_t len = MAX(sq_len, cq_len);
+        sq_ptr = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->ring_fd,
+                      IORING_OFF_SQ_RING);
+        cq_ptr = sq_ptr;
+    } else {
+        sq_ptr = mmap(NULL, sq_len, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->ring_fd,
+                      IORING_OFF_SQ_RING);
+        cq_ptr = mmap(NULL, cq_len, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring->ring_fd,
+                      IORING_OFF_CQ_RING);
+    }
+    if (sq_ptr == MAP_FAILED || cq_ptr == MAP_FAILED) {
+        close(ring->ring_fd);
+        return false;
+    }
+
+    ring->sqes = mmap(NULL, params.sq_entries * sizeof(struct io_uring_sqe),
+                      PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ring->ring_fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        close(ring->ring_fd);
+        return false;
+    }
+
+    ring->sq_entries = params.sq_entries;
+    ring->sq_head = (unsigned *)((uint8_t *)sq_ptr + params.sq_off.head);
+    ring->sq_tail = (unsigned *)((uint8_t *)sq_ptr + params.sq_off.tail);
+    ring->sq_mask = (unsigned *)((uint8_t *)sq_ptr + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned *)((uint8_t *)sq_ptr + params.sq_off.array);
+    ring->cq_head = (unsigned *)((uint8_t *)cq_ptr + params.cq_off.head);
+    ring->cq_tail = (unsigned *)((uint8_t *)cq_ptr + params.cq_off.tail);
+    ring->cq_mask = (unsigned *)((uint8_t *)cq_ptr + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe *)((uint8_t *)cq_ptr +
+                                         params.cq_off.cqes);
+
+    ring->ready = true;
+    return true;
+}
+
+/**
+ * @brief Obtiene el anillo del hilo actual, montándolo si hace falta
+ */
+static io_ring_t *ring_get(void) {
+    if (tls_ring.ready) {
+        return &tls_ring;
+    }
+    if (tls_ring.failed) {
+        return NULL;
+    }
+    if (!ring_init(&tls_ring)) {
+        tls_ring.failed = true;
+        /* Primer fallo: marcar el kernel como sin soporte para que el
+           resto de hilos ni lo intente */
+        atomic_store_explicit(&kernel_support, -1, memory_order_release);
+        return NULL;
+    }
+    return &tls_ring;
+}
+
+/* ==============================
+ * Control del motor
+ * ============================== */
+
+void io_engine_set_enabled(bool enabled) {
+    atomic_store_explicit(&engine_enabled, enabled, memory_order_release);
+    if (enabled) {
+        LOG_INFO("I/O engine: io_uring requested (POSIX fallback if unsupported)");
+    }
+}
+
+bool io_engine_active(void) {
+    if (!atomic_load_explicit(&engine_enabled, memory_order_acquire)) {
+        return false;
+    }
+
+    int support = atomic_load_explicit(&kernel_support, memory_order_acquire);
+    if (support == 0) {
+        /* Probar una sola vez con el anillo del hilo actual */
+        if (ring_get() != NULL) {
+            atomic_store_explicit(&kernel_support, 1, memory_order_release);
+            support = 1;
+        } else {
+            LOG_INFO("io_uring not available on this kernel, using POSIX I/O");
+            support = -1;
+        }
+    }
+    return support > 0;
+}
+
+/* ==============================
+ * Envío y cosecha por lotes
+ * ============================== */
+
+/**
+ * @brief Encola un lote de segmentos y espera todas sus terminaciones
+ * @details Los resultados cortos (res < len) no son error: el segmento
+ *          queda en el array con el resto pendiente (len > 0) y el
+ *          llamador lo reenvía en el siguiente lote. user_data lleva el
+ *          índice del segmento dentro del lote.
+ * @return 0 si todas las terminaciones llegaron, -1 en error
+ */
+static int submit_batch(io_ring_t *ring, uint8_t opcode, int fd,
+                        uint8_t *base, io_segment_t *segs, unsigned count) {
+    unsigned tail = *ring->sq_tail;
+    unsigned mask = *ring->sq_mask;
+
+    for (unsigned i = 0; i < count; i++) {
+        struct io_uring_sqe *sqe = &ring->sqes[tail & mask];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = opcode;
+        sqe->fd = fd;
+        sqe->addr = (uint64_t)(uintptr_t)(base + segs[i].off);
+        sqe->len = segs[i].len;
+        sqe->off = segs[i].off;
+        sqe->user_data = i;
+        ring->sq_array[tail & mask] = tail & mask;
+        tail++;
+    }
+    atomic_store_explicit((_Atomic unsigned *)ring->sq_tail, tail,
+                          memory_order_release);
+
+    /* Una sola syscall envía y espera el lote completo */
+    unsigned done = 0;
+    int ret = sys_io_uring_enter(ring->ring_fd, count, count,
+                                 IORING_ENTER_GETEVENTS);
+    if (ret < 0) {
+        LOG_ERROR("io_uring_enter failed: %s", strerror(errno));
+        return -1;
+    }
+
+    while (done < count) {
+        unsigned head = *ring->cq_head;
+        unsigned cq_tail = atomic_load_explicit(
+            (_Atomic unsigned *)ring->cq_tail, memory_order_acquire);
+
+        if (head == cq_tail) {
+            /* Terminaciones aún en vuelo: esperar las restantes */
+            if (sys_io_uring_enter(ring->ring_fd, 0, count - done,
+                                   IORING_ENTER_GETEVENTS) < 0) {
+                LOG_ERROR("io_uring_enter failed: %s", strerror(errno));
+                return -1;
+            }
+            continue;
+        }
+
+        while (head != cq_tail && done < count) {
+            struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+            unsigned idx = (unsigned)cqe->user_data;
+
+            if (cqe->res < 0) {
+                LOG_ERROR("io_uring op failed: %s", strerror(-cqe->res));
+                atomic_store_explicit((_Atomic unsigned *)ring->cq_head,
+                                      head + 1, memory_order_release);
+                return -1;
+            }
+            if (cqe->res == 0 && segs[idx].len > 0) {
+                LOG_ERROR("io_uring op returned unexpected EOF");
+                atomic_store_explicit((_Atomic unsigned *)ring->cq_head,
+                                      head + 1, memory_order_release);
+                return -1;
+            }
+            if ((uint32_t)cqe->res < segs[idx].len) {
+                /* Transferencia corta: dejar el resto para otro lote */
+                segs[idx].off += (uint32_t)cqe->res;
+                segs[idx].len -= (uint32_t)cqe->res;
+            } else {
+                segs[idx].len = 0;
+            }
+
+            head++;
+            done++;
+        }
+        atomic_store_explicit((_Atomic unsigned *)ring->cq_head, head,
+                              memory_order_release);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Transfiere size bytes completos partiendo en segmentos por lotes
+ */
+static int engine_transfer(uint8_t opcode, int fd, uint8_t *base, size_t size) {
+    io_ring_t *ring = ring_get();
+    if (!ring) {
+        return GSEA_ERROR_FILE;
+    }
+
+    io_segment_t segs[IO_QUEUE_DEPTH];
+    uint64_t next_off = 0;
+    unsigned pending = 0;   /* Restos cortos compactados al frente de segs */
+
+    for (;;) {
+        /* Armar el lote: restos del lote anterior + segmentos nuevos */
+        unsigned count = pending;
+        while (count < IO_QUEUE_DEPTH && next_off < size) {
+            segs[count].off = next_off;
+            segs[count].len = (uint32_t)MIN((uint64_t)IO_SEGMENT_SIZE,
+                                            size - next_off);
+            next_off += segs[count].len;
+            count++;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        if (submit_batch(ring, opcode, fd, base, segs, count) < 0) {
+            return GSEA_ERROR_FILE;
+        }
+
+        /* Compactar segmentos con resto pendiente al frente */
+        pending = 0;
+        for (unsigned i = 0; i < count; i++) {
+            if (segs[i].len > 0) {
+                segs[pending++] = segs[i];
+            }
+        }
+    }
+
+    return GSEA_SUCCESS;
+}
+
+int io_engine_read(int fd, uint8_t *buf, size_t size) {
+    if (fd < 0 || (!buf && size > 0)) {
+        LOG_ERROR("Invalid parameters for io_engine_read");
+        return GSEA_ERROR_ARGS;
+    }
+    if (size == 0) {
+        return GSEA_SUCCESS;
+    }
+    return engine_transfer(IORING_OP_READ, fd, buf, size);
+}
+
+int io_engine_write(int fd, const uint8_t *buf, size_t size) {
+    if (fd < 0 || (!buf && size > 0)) {
+        LOG_ERROR("Invalid parameters for io_engine_write");
+        return GSEA_ERROR_ARGS;
+    }
+    if (size == 0) {
+        return GSEA_SUCCESS;
+    }
+    return engine_transfer(IORING_OP_WRITE, fd, (uint8_t *)buf, size);
+}
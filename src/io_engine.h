@@ -0,0 +1,51 @@
+/**
+ * @file io_engine.h
+ * @brief Motor de E/S por lotes sobre io_uring con fallback POSIX
+ * @details Expone lecturas y escrituras completas de buffers encolando
+ *          varios segmentos en el anillo de envío y cosechándolos con una
+ *          sola llamada a io_uring_enter. Si el kernel no soporta io_uring
+ *          (o el motor está deshabilitado), el llamador debe usar la ruta
+ *          POSIX clásica de file_manager.
+ */
+
+#ifndef IO_ENGINE_H
+#define IO_ENGINE_H
+
+#include "common.h"
+
+/* ==============================
+ * Control del motor
+ * ============================== */
+
+/**
+ * @brief Habilita o deshabilita el motor io_uring en tiempo de ejecución
+ */
+void io_engine_set_enabled(bool enabled);
+
+/**
+ * @brief Indica si el motor está habilitado y el kernel lo soporta
+ * @details La primera llamada prueba io_uring_setup(2); si falla (ENOSYS,
+ *          EPERM, seccomp), el motor queda deshabilitado para todo el
+ *          proceso y los llamadores usan la ruta POSIX.
+ */
+bool io_engine_active(void);
+
+/* ==============================
+ * Operaciones de E/S por lotes
+ * ============================== */
+
+/**
+ * @brief Lee size bytes desde el inicio del archivo en buf
+ * @return GSEA_SUCCESS o GSEA_ERROR_FILE (el llamador puede reintentar
+ *         con la ruta POSIX: las lecturas usan offsets explícitos y no
+ *         mueven la posición del descriptor)
+ */
+int io_engine_read(int fd, uint8_t *buf, size_t size);
+
+/**
+ * @brief Escribe size bytes de buf desde el inicio del archivo
+ * @return GSEA_SUCCESS o GSEA_ERROR_FILE
+ */
+int io_engine_write(int fd, const uint8_t *buf, size_t size);
+
+#endif /* IO_ENGINE_H */
@@ -6,23 +6,52 @@
 
 #include "common.h"
 #include "file_manager.h"
+#include "io_engine.h"
 #include "compression/compression.h"
+#include "compression/lz77.h"
+#include "compression/lzw.h"
+#include "utils/manifest.h"
 #include "encryption/aes.h"
 #include "encryption/chacha20.h"
 #include "encryption/salsa20.h"
 #include "encryption/rc4.h"
 #include "concurrency/thread_pool.h"
+#include "stream.h"
+#include "archive.h"
 #include "utils/arg_parser.h"
+#include "utils/arena.h"
+#include "utils/buffer_pool.h"
+#include "utils/stats.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
 #include <pthread.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <dirent.h>
+#include <errno.h>
 
-/* Estructura para argumentos de tarea de procesamiento */
+/* Archivos por encima de este umbral no se encolan como una sola tarea:
+   se procesan con el pool dividido en bloques (compresión paralela) para
+   que el final de la corrida no quede serializado en un archivo enorme */
+#define LARGE_FILE_SPLIT_THRESHOLD (16u * 1024u * 1024u)
+
+/* Entrada del listado con su tamaño, para planificar por tamaño */
+typedef struct {
+    const char *path;
+    off_t size;
+    time_t mtime;   /* Para la ruta rápida del modo incremental */
+} file_entry_t;
+
+/* Estructura para argumentos de tarea de procesamiento. Las rutas viven
+   en la arena del trabajo con su longitud exacta, no en arrays fijos de
+   MAX_PATH_LENGTH */
 typedef struct {
-    char input_path[MAX_PATH_LENGTH];
-    char output_path[MAX_PATH_LENGTH];
+    const char *input_path;
+    const char *output_path;
     gsea_config_t *config;
     int *error_count;
     pthread_mutex_t *error_mutex;
@@ -37,6 +66,8 @@ static const char* get_compression_algorithm_name(compression_algorithm_t alg) {
         case COMP_HUFFMAN: return "Huffman";
         case COMP_RLE: return "RLE";
         case COMP_LZW: return "LZW";
+        case COMP_AUTO: return "Auto";
+        case COMP_STORE: return "Store";
         default: return "Unknown";
     }
 }
@@ -45,23 +76,63 @@ static const char* get_compression_algorithm_name(compression_algorithm_t alg) {
  * @brief Procesa un archivo individual: compresión/descompresión y/o encriptación/desencriptación
  */
 static int process_file_operations(const char *input_path, const char *output_path,
-                                    const gsea_config_t *config) {
+                                    const gsea_config_t *config,
+                                    thread_pool_t *pool) {
     int result = GSEA_SUCCESS;
     file_buffer_t input = {0};
     file_buffer_t intermediate = {0};
     file_buffer_t output = {0};
-    
+
     if (config->verbose) {
         LOG_INFO("Processing: %s -> %s", input_path, output_path);
     }
-    
-    /* Leer archivo de entrada */
-    result = read_file(input_path, &input);
+
+    /* Con el motor io_uring activo, leer por lotes en lugar de mapear;
+       si no, mapear el archivo de entrada (zero-copy) con read_file como
+       respaldo para sistemas de archivos sin soporte mmap */
+    double stage_start = stats_begin();
+    if (io_engine_active()) {
+        /* read_file reutiliza el almacenamiento del pool si alcanza */
+        buffer_pool_acquire(&input, 0);
+        result = read_file(input_path, &input);
+    } else {
+        result = map_file(input_path, &input);
+        if (result != GSEA_SUCCESS) {
+            result = read_file(input_path, &input);
+        }
+    }
     if (result != GSEA_SUCCESS) {
         LOG_ERROR("Failed to read input file: %s", input_path);
         return result;
     }
-    
+    stats_end(STATS_READ, stage_start, input.size, input.size);
+
+    /* Modo incremental, segunda oportunidad: mtime cambió pero el contenido
+       es idéntico al registrado (touch sin cambios). Se refresca el mtime
+       del manifiesto y no se rehace nada */
+    manifest_t *manifest = manifest_active();
+    uint64_t content_hash = 0;
+    if (manifest) {
+        content_hash = manifest_hash(input.data, input.size);
+        if (!config->force &&
+            manifest_check_hash(manifest, input_path, (off_t)input.size,
+                                content_hash) &&
+            is_regular_file(output_path)) {
+            if (config->verbose) {
+                LOG_INFO("  Unchanged content, skipping: %s", input_path);
+            }
+            manifest_record(manifest, input_path, (off_t)input.size,
+                            content_hash);
+            buffer_pool_release(&input);
+            return GSEA_SUCCESS;
+        }
+    }
+
+    /* Buffers de etapas desde el pool del hilo: el tamaño de la entrada
+       es la mejor pista disponible para la capacidad que necesitarán */
+    buffer_pool_acquire(&intermediate, input.size);
+    buffer_pool_acquire(&output, input.size);
+
     /* Determinar orden de operaciones */
     /* Para reversibilidad: si comprimimos luego encriptamos (compress->encrypt),
        debemos desencriptar luego descomprimir (decrypt->decompress) */
@@ -77,28 +148,39 @@ static int process_file_operations(const char *input_path, const char *output_pa
     if (compress_first) {
         if (config->verbose) LOG_INFO("  [1/2] Compressing with %s...",
                                       get_compression_algorithm_name(config->comp_alg));
-        result = compress_data(current_input, current_output, config->comp_alg);
+        stage_start = stats_begin();
+        result = compress_data_parallel(current_input, current_output,
+                                        config->comp_alg, pool);
         if (result != GSEA_SUCCESS) {
             LOG_ERROR("Compression failed");
             goto cleanup;
         }
+        stats_end(STATS_COMPRESS, stage_start,
+                  current_input->size, current_output->size);
         current_input = &intermediate;
         current_output = &output;
     } else if (decompress_first) {
         if (config->verbose) LOG_INFO("  [1/2] Decompressing with %s...",
                                       get_compression_algorithm_name(config->comp_alg));
-        result = decompress_data(current_input, current_output, config->comp_alg);
+        stage_start = stats_begin();
+        result = decompress_data_parallel(current_input, current_output,
+                                          config->comp_alg, pool);
         if (result != GSEA_SUCCESS) {
             LOG_ERROR("Decompression failed");
             goto cleanup;
         }
+        stats_end(STATS_DECOMPRESS, stage_start,
+                  current_input->size, current_output->size);
         current_input = &intermediate;
         current_output = &output;
     } else if (encrypt_first) {
         if (config->verbose) LOG_INFO("  [1/1] Encrypting...");
-        
+
+        stage_start = stats_begin();
         if (config->enc_alg == ENC_AES128) {
             result = aes_encrypt(current_input, &output, (uint8_t *)config->key, config->key_len);
+        } else if (config->enc_alg == ENC_AES128_CTR) {
+            result = aes_encrypt_ctr(current_input, &output, (uint8_t *)config->key, config->key_len);
         } else if (config->enc_alg == ENC_CHACHA20) {
             result = chacha20_encrypt(current_input, &output, (uint8_t *)config->key, config->key_len);
         } else if (config->enc_alg == ENC_SALSA20) {
@@ -114,11 +196,14 @@ static int process_file_operations(const char *input_path, const char *output_pa
             LOG_ERROR("Encryption failed");
             goto cleanup;
         }
+        stats_end(STATS_ENCRYPT, stage_start,
+                  current_input->size, output.size);
         current_input = &output;
     } else if (decrypt_first) {
         if (config->verbose) LOG_INFO("  [1/1] Decrypting...");
-        
-        if (config->enc_alg == ENC_AES128) {
+
+        stage_start = stats_begin();
+        if (config->enc_alg == ENC_AES128 || config->enc_alg == ENC_AES128_CTR) {
             result = aes_decrypt(current_input, &output, (uint8_t *)config->key, config->key_len);
         } else if (config->enc_alg == ENC_CHACHA20) {
             result = chacha20_decrypt(current_input, &output, (uint8_t *)config->key, config->key_len);
@@ -135,19 +220,28 @@ static int process_file_operations(const char *input_path, const char *output_pa
             LOG_ERROR("Decryption failed");
             goto cleanup;
         }
+        stats_end(STATS_DECRYPT, stage_start,
+                  current_input->size, output.size);
         current_input = &output;
-    } 
+    }
     
     /* Segunda operación (si existe) */
     if ((compress_first || decrypt_first) && 
         (config->operations & (OP_ENCRYPT | OP_DECOMPRESS))) {
         
+        stage_start = stats_begin();
+        size_t second_in = current_input->size;
+        stats_stage_t second_stage;
         if (config->operations & OP_ENCRYPT) {
+            second_stage = STATS_ENCRYPT;
             if (config->verbose) LOG_INFO("  [2/2] Encrypting...");
-            
+
             if (config->enc_alg == ENC_AES128) {
-                result = aes_encrypt(current_input, current_output, 
+                result = aes_encrypt(current_input, current_output,
                                    (uint8_t *)config->key, config->key_len);
+            } else if (config->enc_alg == ENC_AES128_CTR) {
+                result = aes_encrypt_ctr(current_input, current_output,
+                                         (uint8_t *)config->key, config->key_len);
             } else if (config->enc_alg == ENC_CHACHA20) {
                 result = chacha20_encrypt(current_input, current_output, 
                                         (uint8_t *)config->key, config->key_len);
@@ -162,35 +256,144 @@ static int process_file_operations(const char *input_path, const char *output_pa
                 result = GSEA_ERROR_ENCRYPTION;
             }
         } else {
+            second_stage = STATS_DECOMPRESS;
             if (config->verbose) LOG_INFO("  [2/2] Decompressing with %s...",
                                           get_compression_algorithm_name(config->comp_alg));
-            result = decompress_data(current_input, current_output, config->comp_alg);
+            result = decompress_data_parallel(current_input, current_output,
+                                              config->comp_alg, pool);
         }
-        
+
         if (result != GSEA_SUCCESS) {
             LOG_ERROR("Second operation failed");
             goto cleanup;
         }
+        stats_end(second_stage, stage_start, second_in, current_output->size);
         current_input = current_output;
     }
     
     /* Escribir archivo de salida */
+    stage_start = stats_begin();
     result = write_file(output_path, current_input);
     if (result != GSEA_SUCCESS) {
         LOG_ERROR("Failed to write output file: %s", output_path);
         goto cleanup;
     }
-    
+    stats_end(STATS_WRITE, stage_start,
+              current_input->size, current_input->size);
+
+    /* Registrar el archivo procesado para la siguiente corrida incremental */
+    if (manifest) {
+        manifest_record(manifest, input_path, (off_t)input.size, content_hash);
+    }
+
+    if (stats_is_enabled()) {
+        double ratio = (input.size > 0)
+                           ? (double)current_input->size / (double)input.size
+                           : 0.0;
+        LOG_INFO("  [stats] %s: %zu -> %zu bytes (ratio %.3f)",
+                 input_path, input.size, current_input->size, ratio);
+    }
+
     if (config->verbose) {
-        LOG_INFO("  Completed: %zu bytes -> %zu bytes", 
+        LOG_INFO("  Completed: %zu bytes -> %zu bytes",
                  input.size, current_input->size);
     }
     
 cleanup:
+    /* Devolver el almacenamiento a la caché del hilo para el siguiente
+       archivo (los buffers mapeados se liberan con munmap como siempre) */
+    buffer_pool_release(&input);
+    buffer_pool_release(&intermediate);
+    buffer_pool_release(&output);
+
+    return result;
+}
+
+/**
+ * @brief Comparador para ordenar archivos de mayor a menor tamaño
+ */
+static int compare_file_size_desc(const void *a, const void *b) {
+    const file_entry_t *fa = (const file_entry_t *)a;
+    const file_entry_t *fb = (const file_entry_t *)b;
+    if (fa->size < fb->size) return 1;
+    if (fa->size > fb->size) return -1;
+    return 0;
+}
+
+/**
+ * @brief Extrae un rango sin comprimir de un archivo comprimido
+ * @details Con el formato multi-bloque solo se decodifican los bloques que
+ *          cubren el rango; con el formato monolítico no hay índice, así
+ *          que se descomprime completo y se recorta (con aviso).
+ */
+static int process_extract_range(const gsea_config_t *config) {
+    file_buffer_t input = {0};
+    file_buffer_t output = {0};
+    int result;
+
+    result = map_file(config->input_path, &input);
+    if (result != GSEA_SUCCESS) {
+        result = read_file(config->input_path, &input);
+    }
+    if (result != GSEA_SUCCESS) {
+        LOG_ERROR("Failed to read input file: %s", config->input_path);
+        return result;
+    }
+
+    bool multiblock = input.size >= 8 &&
+                      memcmp(input.data, "GSEAMB01", 8) == 0;
+    /* Envoltorio de selección automática: mirar el payload que sigue */
+    if (!multiblock && input.size >= 17 &&
+        memcmp(input.data, "GSEAAL01", 8) == 0) {
+        multiblock = memcmp(input.data + 9, "GSEAMB01", 8) == 0;
+    }
+    /* El formato store es de acceso aleatorio directo: misma ruta */
+    if (!multiblock && input.size >= 8 &&
+        memcmp(input.data, "GSEARW01", 8) == 0) {
+        multiblock = true;
+    }
+
+    if (multiblock) {
+        thread_pool_t *pool = NULL;
+        if (config->num_threads > 1) {
+            pool = thread_pool_create(config->num_threads);
+        }
+        result = decompress_range_parallel(&input, &output, config->comp_alg,
+                                           config->range_offset,
+                                           config->range_length, pool);
+        if (pool) {
+            thread_pool_destroy(pool);
+        }
+    } else {
+        LOG_INFO("Monolithic stream (no chunk index): decompressing fully");
+        file_buffer_t full = {0};
+        result = decompress_data(&input, &full, config->comp_alg);
+        if (result == GSEA_SUCCESS) {
+            if (config->range_offset >= full.size ||
+                config->range_length > full.size - config->range_offset) {
+                LOG_ERROR("Range out of bounds (original size %zu)", full.size);
+                result = GSEA_ERROR_ARGS;
+            } else {
+                output.capacity = config->range_length;
+                output.data = malloc(output.capacity);
+                if (!output.data) {
+                    result = GSEA_ERROR_MEMORY;
+                } else {
+                    memcpy(output.data, full.data + config->range_offset,
+                           config->range_length);
+                    output.size = config->range_length;
+                }
+            }
+            free(full.data);
+        }
+    }
+
+    if (result == GSEA_SUCCESS) {
+        result = write_file(config->output_path, &output);
+    }
+
+    free(output.data);
     free_buffer(&input);
-    free_buffer(&intermediate);
-    free_buffer(&output);
-    
     return result;
 }
 
@@ -200,16 +403,234 @@ cleanup:
 static void process_file_worker(void *arg) {
     process_args_t *args = (process_args_t *)arg;
     
-    int result = process_file_operations(args->input_path, args->output_path, 
-                                         args->config);
+    /* Sin pool anidado: en modo directorio el paralelismo es entre archivos */
+    int result = process_file_operations(args->input_path, args->output_path,
+                                         args->config, NULL);
     
     if (result != GSEA_SUCCESS) {
         pthread_mutex_lock(args->error_mutex);
         (*args->error_count)++;
         pthread_mutex_unlock(args->error_mutex);
     }
-    
-    free(args);
+
+    /* Los argumentos viven en la arena del trabajo: sin free individual */
+}
+
+/* Directorio pendiente del recorrido recursivo */
+typedef struct dir_stack_entry {
+    const char *in_dir;             /* Ruta absoluta/relativa de entrada */
+    const char *rel;                /* Ruta relativa al directorio raíz */
+    struct dir_stack_entry *next;
+} dir_stack_entry_t;
+
+/**
+ * @brief Procesa un árbol de directorios recursivamente
+ * @details El recorrido corre en el hilo coordinador y encola cada archivo
+ *          descubierto de inmediato, así los workers procesan mientras la
+ *          enumeración sigue: la latencia del walk de metadatos queda
+ *          solapada con el trabajo. Usa d_type del dirent (con stat solo
+ *          como respaldo) para clasificar cada entrada una única vez. El
+ *          árbol de salida replica la estructura del de entrada.
+ */
+static int process_directory_recursive(const gsea_config_t *config) {
+    arena_t *arena = arena_create(0);
+    if (!arena) {
+        LOG_ERROR("Failed to create job arena");
+        return GSEA_ERROR_MEMORY;
+    }
+
+    pthread_mutex_t error_mutex = PTHREAD_MUTEX_INITIALIZER;
+    int error_count = 0;
+    int file_count = 0;
+    int result = GSEA_SUCCESS;
+
+    if (!is_directory(config->output_path)) {
+        result = create_directory(config->output_path);
+        if (result != GSEA_SUCCESS) {
+            arena_destroy(arena);
+            return result;
+        }
+    }
+
+    /* Modo incremental: mismo manifiesto que en el modo plano, con rutas
+       relativas completas como clave */
+    manifest_t *manifest = NULL;
+    int skipped_count = 0;
+    if (config->incremental) {
+        manifest = manifest_load(config->output_path);
+        manifest_set_active(manifest);
+    }
+
+    thread_pool_t *pool = thread_pool_create(config->num_threads);
+    if (!pool) {
+        manifest_set_active(NULL);
+        manifest_destroy(manifest);
+        arena_destroy(arena);
+        return GSEA_ERROR_THREAD;
+    }
+
+    /* Pila de directorios pendientes (LIFO, sin recursión de C) */
+    dir_stack_entry_t *stack = arena_alloc(arena, sizeof(dir_stack_entry_t));
+    if (!stack) {
+        thread_pool_destroy(pool);
+        arena_destroy(arena);
+        return GSEA_ERROR_MEMORY;
+    }
+    stack->in_dir = config->input_path;
+    stack->rel = "";
+    stack->next = NULL;
+
+    while (stack) {
+        dir_stack_entry_t *current = stack;
+        stack = stack->next;
+
+        DIR *dir = opendir(current->in_dir);
+        if (!dir) {
+            LOG_ERROR("Failed to open directory '%s': %s", current->in_dir,
+                      strerror(errno));
+            error_count++;
+            continue;
+        }
+
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL) {
+            if (strcmp(entry->d_name, ".") == 0 ||
+                strcmp(entry->d_name, "..") == 0 ||
+                strcmp(entry->d_name, MANIFEST_FILENAME) == 0) {
+                continue;
+            }
+
+            char in_path[MAX_PATH_LENGTH];
+            char rel_path[MAX_PATH_LENGTH];
+            int w1 = snprintf(in_path, sizeof(in_path), "%s/%s",
+                              current->in_dir, entry->d_name);
+            int w2 = snprintf(rel_path, sizeof(rel_path), "%s%s%s",
+                              current->rel, current->rel[0] ? "/" : "",
+                              entry->d_name);
+            if (w1 < 0 || w1 >= (int)sizeof(in_path) ||
+                w2 < 0 || w2 >= (int)sizeof(rel_path)) {
+                LOG_ERROR("Path too long, skipping: %s/%s",
+                          current->in_dir, entry->d_name);
+                error_count++;
+                continue;
+            }
+
+            /* Clasificar con d_type; stat solo si el FS no lo reporta */
+            bool is_dir, is_reg;
+            if (entry->d_type != DT_UNKNOWN) {
+                is_dir = (entry->d_type == DT_DIR);
+                is_reg = (entry->d_type == DT_REG);
+            } else {
+                is_dir = is_directory(in_path);
+                is_reg = !is_dir && is_regular_file(in_path);
+            }
+
+            if (is_dir) {
+                /* Crear el espejo en la salida antes de encolar sus hijos */
+                char out_dir[MAX_PATH_LENGTH];
+                int w = snprintf(out_dir, sizeof(out_dir), "%s/%s",
+                                 config->output_path, rel_path);
+                if (w < 0 || w >= (int)sizeof(out_dir) ||
+                    create_directory(out_dir) != GSEA_SUCCESS) {
+                    error_count++;
+                    continue;
+                }
+
+                dir_stack_entry_t *child =
+                    arena_alloc(arena, sizeof(dir_stack_entry_t));
+                if (!child) {
+                    error_count++;
+                    continue;
+                }
+                child->in_dir = arena_strdup(arena, in_path);
+                child->rel = arena_strdup(arena, rel_path);
+                if (!child->in_dir || !child->rel) {
+                    error_count++;
+                    continue;
+                }
+                child->next = stack;
+                stack = child;
+                continue;
+            }
+
+            if (!is_reg) {
+                continue;
+            }
+
+            char out_path[MAX_PATH_LENGTH];
+            int w = snprintf(out_path, sizeof(out_path), "%s/%s",
+                             config->output_path, rel_path);
+            if (w < 0 || w >= (int)sizeof(out_path)) {
+                LOG_ERROR("Output path too long, skipping: %s", rel_path);
+                error_count++;
+                continue;
+            }
+
+            /* Salto rápido incremental (tamaño + mtime intactos) antes de
+               gastar una tarea del pool en el archivo */
+            if (manifest && !config->force) {
+                struct stat st;
+                if (stat(in_path, &st) == 0 &&
+                    manifest_check(manifest, in_path, st.st_size,
+                                   st.st_mtime) &&
+                    is_regular_file(out_path)) {
+                    skipped_count++;
+                    continue;
+                }
+            }
+
+            /* Encolar el archivo de inmediato: los workers arrancan
+               mientras el recorrido continúa */
+            process_args_t *args = arena_alloc(arena, sizeof(process_args_t));
+            if (!args) {
+                error_count++;
+                continue;
+            }
+
+            args->input_path = arena_strdup(arena, in_path);
+            args->output_path = arena_strdup(arena, out_path);
+            if (!args->input_path || !args->output_path) {
+                error_count++;
+                continue;
+            }
+            args->config = (gsea_config_t *)config;
+            args->error_count = &error_count;
+            args->error_mutex = &error_mutex;
+
+            if (thread_pool_add_task(pool, process_file_worker,
+                                     args) != GSEA_SUCCESS) {
+                error_count++;
+                continue;
+            }
+            file_count++;
+        }
+
+        closedir(dir);
+    }
+
+    thread_pool_wait(pool);
+
+    if (manifest) {
+        manifest_set_active(NULL);
+        manifest_save(manifest, config->output_path);
+        manifest_destroy(manifest);
+        if (skipped_count > 0) {
+            LOG_INFO("Skipped %d unchanged files (manifest match)",
+                     skipped_count);
+        }
+    }
+
+    thread_pool_destroy(pool);
+    arena_destroy(arena);
+    pthread_mutex_destroy(&error_mutex);
+
+    if (error_count > 0) {
+        LOG_ERROR("Processing completed with %d errors", error_count);
+        return GSEA_ERROR_FILE;
+    }
+
+    LOG_INFO("Processed %d files recursively", file_count);
+    return GSEA_SUCCESS;
 }
 
 /**
@@ -222,64 +643,132 @@ static int process_directory(const gsea_config_t *config) {
     thread_pool_t *pool = NULL;
     pthread_mutex_t error_mutex = PTHREAD_MUTEX_INITIALIZER;
     int error_count = 0;
-    
+
+    /* Arena del trabajo: rutas, listado y argumentos de tarea salen de
+       aquí y se liberan en bloque al final */
+    arena_t *arena = arena_create(0);
+    if (!arena) {
+        LOG_ERROR("Failed to create job arena");
+        return GSEA_ERROR_MEMORY;
+    }
+
     /* Listar archivos en el directorio de entrada */
-    result = list_directory(config->input_path, &files, &file_count);
+    result = list_directory(config->input_path, arena, &files, &file_count);
     if (result != GSEA_SUCCESS) {
         LOG_ERROR("Failed to list directory: %s", config->input_path);
+        arena_destroy(arena);
         return result;
     }
-    
+
     if (file_count == 0) {
         LOG_INFO("No files found in directory: %s", config->input_path);
-        free_file_list(files, file_count);
+        arena_destroy(arena);
         return GSEA_SUCCESS;
     }
-    
+
     LOG_INFO("Found %d files to process", file_count);
-    
+
     /* Crear directorio de salida si no existe */
     if (!is_directory(config->output_path)) {
         result = create_directory(config->output_path);
         if (result != GSEA_SUCCESS) {
             LOG_ERROR("Failed to create output directory");
-            free_file_list(files, file_count);
+            arena_destroy(arena);
             return result;
         }
     }
-    
+
     /* Crear pool de hilos */
     int num_threads = (file_count < config->num_threads) ? file_count : config->num_threads;
     pool = thread_pool_create(num_threads);
     if (!pool) {
         LOG_ERROR("Failed to create thread pool");
-        free_file_list(files, file_count);
+        arena_destroy(arena);
         return GSEA_ERROR_THREAD;
     }
-    
-    /* Encolar tareas para cada archivo */
+
+    /* Planificación por tamaño: los archivos grandes primero, para que el
+       final de la corrida no quede esperando a un solo hilo */
+    file_entry_t *entries = arena_alloc(arena, file_count * sizeof(file_entry_t));
+    if (!entries) {
+        LOG_ERROR("Memory allocation failed for file entries");
+        thread_pool_destroy(pool);
+        arena_destroy(arena);
+        return GSEA_ERROR_MEMORY;
+    }
     for (int i = 0; i < file_count; i++) {
-        process_args_t *args = malloc(sizeof(process_args_t));
-        if (!args) {
-            LOG_ERROR("Memory allocation failed for process args");
-            error_count++;
-            continue;
-        }
+        struct stat st;
+        bool have_stat = (stat(files[i], &st) == 0);
+        entries[i].path = files[i];
+        entries[i].size = have_stat ? st.st_size : 0;
+        entries[i].mtime = have_stat ? st.st_mtime : 0;
+    }
+    qsort(entries, file_count, sizeof(file_entry_t), compare_file_size_desc);
 
-        /* Construir ruta de salida */
-        const char *filename = strrchr(files[i], '/');
-        filename = filename ? filename + 1 : files[i];
+    /* Modo incremental: el manifiesto vive junto a las salidas. Los workers
+       registran las entradas nuevas; aquí solo se decide el salto rápido */
+    manifest_t *manifest = NULL;
+    int skipped_count = 0;
+    if (config->incremental) {
+        manifest = manifest_load(config->output_path);
+        manifest_set_active(manifest);
+    }
+
+    /* Los archivos por encima del umbral se dividen en subtareas de bloque
+       sobre el mismo pool (el hilo principal coordina; los workers
+       comprimen bloques), de modo que también paralelizan por dentro */
+    bool can_split = (config->operations & (OP_COMPRESS | OP_DECOMPRESS)) != 0;
 
-        strncpy(args->input_path, files[i], MAX_PATH_LENGTH - 1);
-        args->input_path[MAX_PATH_LENGTH - 1] = '\0';
+    for (int i = 0; i < file_count; i++) {
+        /* Construir ruta de salida */
+        const char *filename = strrchr(entries[i].path, '/');
+        filename = filename ? filename + 1 : entries[i].path;
 
-        int written = snprintf(args->output_path, MAX_PATH_LENGTH, "%s/%s",
-                            config->output_path, filename);
+        /* El manifiesto de una corrida anterior no es un archivo de datos */
+        if (strcmp(filename, MANIFEST_FILENAME) == 0) {
+            continue;
+        }
 
+        char output_path[MAX_PATH_LENGTH];
+        int written = snprintf(output_path, MAX_PATH_LENGTH, "%s/%s",
+                               config->output_path, filename);
         if (written < 0 || written >= (int)MAX_PATH_LENGTH) {
             LOG_ERROR("Output path too long, truncated: %s/%s",
-                    config->output_path, filename);
-            args->output_path[MAX_PATH_LENGTH - 1] = '\0';
+                      config->output_path, filename);
+            output_path[MAX_PATH_LENGTH - 1] = '\0';
+        }
+
+        /* Salto rápido incremental: tamaño y mtime intactos y la salida
+           existe; ni siquiera se relee el archivo */
+        if (manifest && !config->force &&
+            manifest_check(manifest, entries[i].path, entries[i].size,
+                           entries[i].mtime) &&
+            is_regular_file(output_path)) {
+            skipped_count++;
+            continue;
+        }
+
+        if (can_split && entries[i].size >= (off_t)LARGE_FILE_SPLIT_THRESHOLD) {
+            if (process_file_operations(entries[i].path, output_path,
+                                        config, pool) != GSEA_SUCCESS) {
+                error_count++;
+            }
+            continue;
+        }
+
+        process_args_t *args = arena_alloc(arena, sizeof(process_args_t));
+        if (!args) {
+            LOG_ERROR("Memory allocation failed for process args");
+            error_count++;
+            continue;
+        }
+
+        /* La ruta de entrada ya vive en la arena (viene del listado) */
+        args->input_path = entries[i].path;
+        args->output_path = arena_strdup(arena, output_path);
+        if (!args->output_path) {
+            error_count++;
+            continue;
         }
 
         args->config = (gsea_config_t *)config;
@@ -288,25 +777,36 @@ static int process_directory(const gsea_config_t *config) {
 
         if (thread_pool_add_task(pool, process_file_worker, args) != GSEA_SUCCESS) {
             LOG_ERROR("Failed to add task to thread pool");
-            free(args);
             error_count++;
         }
     }
 
-    
     /* Esperar a que terminen todas las tareas */
     thread_pool_wait(pool);
-    
-    /* Limpiar */
+
+    /* Persistir el manifiesto con las entradas que registraron los workers */
+    if (manifest) {
+        manifest_set_active(NULL);
+        /* Se guarda aunque haya errores: los archivos que sí terminaron
+           quedan registrados y la siguiente corrida solo rehace el resto */
+        manifest_save(manifest, config->output_path);
+        manifest_destroy(manifest);
+        if (skipped_count > 0) {
+            LOG_INFO("Skipped %d unchanged files (manifest match)",
+                     skipped_count);
+        }
+    }
+
+    /* Limpiar: la arena libera listado, rutas y argumentos en bloque */
     thread_pool_destroy(pool);
-    free_file_list(files, file_count);
+    arena_destroy(arena);
     pthread_mutex_destroy(&error_mutex);
-    
+
     if (error_count > 0) {
         LOG_ERROR("Processing completed with %d errors", error_count);
         return GSEA_ERROR_FILE;
     }
-    
+
     LOG_INFO("All files processed successfully");
     return GSEA_SUCCESS;
 }
@@ -314,58 +814,492 @@ static int process_directory(const gsea_config_t *config) {
 /**
  * @brief Función principal
  */
+/**
+ * @brief Ejecuta un trabajo completo según la configuración dada
+ * @details Aplica el estado por-módulo que el trabajo pide (nivel y
+ *          diccionario de compresión, motor de E/S, política de fsync,
+ *          caché de páginas, stats) y despacha a la ruta adecuada:
+ *          directorio, contenedor .gsea, rango, streaming o archivo
+ *          individual. Es el cuerpo compartido entre la invocación CLI
+ *          normal y los trabajos que llegan al daemon por el socket.
+ * @param config Configuración del trabajo (ya validada por el parser)
+ * @param warm_pool Pool de hilos precalentado del daemon, o NULL para
+ *        crear/destruir uno por trabajo como hace la CLI
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+static int run_job(gsea_config_t *config, thread_pool_t *warm_pool) {
+    int result;
+    bool stdio_in = strcmp(config->input_path, "-") == 0;
+    bool stdio_out = strcmp(config->output_path, "-") == 0;
+
+    /* Aplicar nivel de compresión (por ahora solo lo usa LZ77) */
+    lz77_set_level(config->comp_level);
+
+    /* Cargar diccionario preset si se pidió; debe vivir hasta terminar
+       porque los codecs solo guardan el puntero */
+    file_buffer_t dict_buf = {0};
+    if (config->dict_path[0] != '\0') {
+        result = read_file(config->dict_path, &dict_buf);
+        if (result != GSEA_SUCCESS) {
+            LOG_ERROR("Could not read dictionary file: %s", config->dict_path);
+            return result;
+        }
+        lz77_set_dictionary(dict_buf.data, dict_buf.size);
+        lzw_set_dictionary(dict_buf.data, dict_buf.size);
+        LOG_INFO("Preset dictionary loaded: %s (%zu bytes)",
+                 config->dict_path, dict_buf.size);
+    }
+
+    /* Seleccionar motor de E/S (io_uring con fallback POSIX) */
+    io_engine_set_enabled(config->io_uring);
+
+    /* Política de durabilidad de las salidas */
+    file_manager_set_fsync_policy(config->fsync_policy);
+
+    /* Control de caché de páginas para trabajos grandes de una pasada */
+    file_manager_set_streaming_io(config->streaming_io);
+
+    /* Instrumentación por etapa (--stats) */
+    stats_enable(config->stats);
+
+    /* Mostrar configuración */
+    if (config->verbose) {
+        LOG_INFO("Configuration:");
+        LOG_INFO("  Input: %s", config->input_path);
+        LOG_INFO("  Output: %s", config->output_path);
+        LOG_INFO("  Operations: %s%s%s%s",
+                 (config->operations & OP_COMPRESS) ? "COMPRESS " : "",
+                 (config->operations & OP_DECOMPRESS) ? "DECOMPRESS " : "",
+                 (config->operations & OP_ENCRYPT) ? "ENCRYPT " : "",
+                 (config->operations & OP_DECRYPT) ? "DECRYPT " : "");
+        LOG_INFO("  Threads: %d", config->num_threads);
+    }
+
+    /* Procesar entrada */
+    if (stdio_in || stdio_out) {
+        /* stdin/stdout no son seekables ni tienen tamaño conocido: siempre
+           van por el pipeline de chunks, que solo lee y escribe en orden */
+        result = process_file_streaming(config->input_path, config->output_path,
+                                        config);
+    } else if (is_directory(config->input_path)) {
+        /* Salida .gsea: contenedor empaquetado en lugar de un archivo
+           de salida por entrada */
+        size_t out_len = strlen(config->output_path);
+        if (out_len > 5 &&
+            strcmp(config->output_path + out_len - 5, ".gsea") == 0) {
+            result = archive_pack(config);
+        } else if (config->recursive) {
+            result = process_directory_recursive(config);
+        } else {
+            result = process_directory(config);
+        }
+    } else if (is_regular_file(config->input_path)) {
+        if (config->extract_range) {
+            result = process_extract_range(config);
+        } else if ((config->operations & (OP_DECOMPRESS | OP_DECRYPT)) &&
+            archive_is_archive(config->input_path)) {
+            result = archive_unpack(config);
+        } else if ((config->operations & (OP_DECOMPRESS | OP_DECRYPT)) &&
+            stream_is_stream(config->input_path)) {
+            /* Contenedor GSEASTR1 (salidas de --stream o de -o -): solo se
+               deshace chunk a chunk, pida o no --stream el usuario */
+            result = process_file_streaming(config->input_path,
+                                            config->output_path, config);
+        } else if (config->stream) {
+            result = process_file_streaming(config->input_path, config->output_path, config);
+        } else {
+            /* Pool para compresión por bloques dentro del archivo: el del
+               daemon si hay uno caliente, propio en caso contrario */
+            thread_pool_t *pool = warm_pool;
+            if (!pool && config->num_threads > 1) {
+                pool = thread_pool_create(config->num_threads);
+            }
+            result = process_file_operations(config->input_path, config->output_path,
+                                             config, pool);
+            if (pool && pool != warm_pool) {
+                thread_pool_destroy(pool);
+            }
+        }
+    } else {
+        LOG_ERROR("Input path does not exist or is not accessible: %s",
+                  config->input_path);
+        result = GSEA_ERROR_FILE;
+    }
+
+    /* Política FSYNC_END: un solo syncfs cubre todas las salidas del
+       trabajo, en lugar de pagar la latencia de flush archivo a archivo */
+    if (result == GSEA_SUCCESS && config->fsync_policy == FSYNC_END &&
+        !stdio_out) {
+        result = file_manager_sync_output(config->output_path);
+    }
+
+    /* El diccionario muere con el trabajo: limpiar el estado de los codecs
+       para que el siguiente trabajo del daemon no lo herede */
+    if (dict_buf.data) {
+        lz77_set_dictionary(NULL, 0);
+        lzw_set_dictionary(NULL, 0);
+        free_buffer(&dict_buf);
+    }
+
+    return result;
+}
+
+/* ==================== MODO DAEMON (SOCKET UNIX) ==================== */
+/* Un proceso residente escucha en un socket unix y ejecuta trabajos que
+   un cliente delgado (--remote) le reenvía como argv serializado. El
+   daemon mantiene el pool de hilos y la caché de buffers calientes, así
+   que cada trabajo se ahorra el arranque del proceso, la creación de
+   hilos y el primer llenado del pool de buffers.
+
+   Protocolo (enteros little-endian del lado de ambos, misma máquina):
+     petición:  u32 count, luego count veces { u32 len, len bytes }
+     respuesta: i32 status (código GSEA_*; 0 = éxito) */
+
+/* Límite de sanidad del protocolo, no de diseño (como MAX_THREADS) */
+#define DAEMON_MAX_ARGS 64
+
+/**
+ * @brief Escribe exactamente len bytes al socket (reintenta parciales)
+ */
+static int sock_write_all(int fd, const void *buf, size_t len) {
+    const uint8_t *p = buf;
+    while (len > 0) {
+        /* MSG_NOSIGNAL: un cliente que muere no debe tumbar al daemon */
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return GSEA_ERROR_FILE;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Lee exactamente len bytes del socket (reintenta parciales)
+ */
+static int sock_read_all(int fd, void *buf, size_t len) {
+    uint8_t *p = buf;
+    while (len > 0) {
+        ssize_t n = recv(fd, p, len, 0);
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            return GSEA_ERROR_FILE;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Atiende una conexión: deserializa argv, ejecuta y responde
+ * @param client_fd Conexión aceptada
+ * @param warm_pool Pool de hilos caliente del daemon
+ * @param stop Salida: true si el cliente pidió --daemon-stop
+ */
+static void daemon_handle_client(int client_fd, thread_pool_t *warm_pool,
+                                 bool *stop) {
+    char *args[DAEMON_MAX_ARGS + 1];  /* +1 para el argv[0] sintético */
+    uint32_t count = 0;
+    uint32_t received = 0;
+    int status = GSEA_SUCCESS;
+
+    if (sock_read_all(client_fd, &count, sizeof(count)) != GSEA_SUCCESS ||
+        count == 0 || count > DAEMON_MAX_ARGS) {
+        LOG_ERROR("Malformed daemon request (count=%u)", count);
+        status = GSEA_ERROR_ARGS;
+        count = 0;
+    }
+
+    args[0] = "gsea";
+    for (uint32_t n = 0; n < count; n++) {
+        uint32_t len;
+        if (sock_read_all(client_fd, &len, sizeof(len)) != GSEA_SUCCESS ||
+            len >= MAX_PATH_LENGTH) {
+            status = GSEA_ERROR_ARGS;
+            break;
+        }
+        char *arg = malloc(len + 1);
+        if (!arg) {
+            status = GSEA_ERROR_MEMORY;
+            break;
+        }
+        if (sock_read_all(client_fd, arg, len) != GSEA_SUCCESS) {
+            free(arg);
+            status = GSEA_ERROR_FILE;
+            break;
+        }
+        arg[len] = '\0';
+        args[n + 1] = arg;
+        received++;
+    }
+
+    if (status == GSEA_SUCCESS) {
+        for (uint32_t n = 0; n < received; n++) {
+            if (strcmp(args[n + 1], "--daemon-stop") == 0) {
+                *stop = true;
+            }
+        }
+    }
+
+    if (status == GSEA_SUCCESS && !*stop) {
+        gsea_config_t job;
+        status = parse_arguments((int)received + 1, args, &job);
+        if (status == GSEA_SUCCESS &&
+            (job.daemon || job.remote ||
+             strcmp(job.input_path, "-") == 0 ||
+             strcmp(job.output_path, "-") == 0)) {
+            /* Ni daemons anidados ni stdio: los fds estándar del cliente
+               no viajan por el socket */
+            LOG_ERROR("Rejected job: daemon flags or stdio paths");
+            status = GSEA_ERROR_ARGS;
+        }
+        if (status == GSEA_SUCCESS) {
+            double t0 = stats_now();
+            status = run_job(&job, warm_pool);
+            LOG_INFO("Job %s -> %s: %s (%.3f s)",
+                     job.input_path, job.output_path,
+                     (status == GSEA_SUCCESS) ? "done" : "failed",
+                     stats_now() - t0);
+        }
+    }
+
+    for (uint32_t n = 0; n < received; n++) {
+        free(args[n + 1]);
+    }
+
+    int32_t reply = (int32_t)status;
+    sock_write_all(client_fd, &reply, sizeof(reply));
+}
+
+/**
+ * @brief Bucle del daemon: acepta conexiones y sirve trabajos en orden
+ * @details Los trabajos se atienden secuencialmente; el paralelismo vive
+ *          dentro de cada trabajo (pool caliente de num_threads hilos),
+ *          igual que en una invocación CLI normal.
+ * @param config Configuración del daemon (socket_path, num_threads)
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+static int daemon_serve(const gsea_config_t *config) {
+    struct sockaddr_un addr;
+    size_t path_len = strlen(config->socket_path);
+
+    if (path_len >= sizeof(addr.sun_path)) {
+        LOG_ERROR("Socket path too long: %s", config->socket_path);
+        return GSEA_ERROR_ARGS;
+    }
+
+    int listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        LOG_ERROR("Failed to create socket: %s", strerror(errno));
+        return GSEA_ERROR_FILE;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, config->socket_path, path_len);
+
+    /* Retirar un socket huérfano de una corrida anterior */
+    unlink(config->socket_path);
+
+    if (bind(listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        LOG_ERROR("Failed to bind %s: %s", config->socket_path,
+                  strerror(errno));
+        close(listen_fd);
+        return GSEA_ERROR_FILE;
+    }
+    if (listen(listen_fd, 8) < 0) {
+        LOG_ERROR("Failed to listen on %s: %s", config->socket_path,
+                  strerror(errno));
+        close(listen_fd);
+        unlink(config->socket_path);
+        return GSEA_ERROR_FILE;
+    }
+
+    /* El pool caliente es el punto del modo daemon: se paga una vez */
+    thread_pool_t *warm_pool = NULL;
+    if (config->num_threads > 1) {
+        warm_pool = thread_pool_create(config->num_threads);
+    }
+
+    LOG_INFO("Daemon listening on %s (%d threads warm)",
+             config->socket_path, config->num_threads);
+
+    bool stop = false;
+    while (!stop) {
+        int client_fd = accept(listen_fd, NULL, NULL);
+        if (client_fd < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR("accept failed: %s", strerror(errno));
+            break;
+        }
+        daemon_handle_client(client_fd, warm_pool, &stop);
+        close(client_fd);
+    }
+
+    if (warm_pool) {
+        thread_pool_destroy(warm_pool);
+    }
+    close(listen_fd);
+    unlink(config->socket_path);
+    LOG_INFO("Daemon stopped");
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Cliente delgado: reenvía el argv de esta invocación al daemon
+ * @details Se omiten los argumentos de transporte (--remote y --socket,
+ *          que solo indican a dónde conectar); el resto viaja tal cual y
+ *          el daemon lo parsea con el mismo parse_arguments de la CLI.
+ * @param config Configuración local (solo se usa socket_path)
+ * @param argc Cantidad de argumentos originales
+ * @param argv Argumentos originales de esta invocación
+ * @return Código de estado que reportó el daemon para el trabajo
+ */
+static int daemon_submit(const gsea_config_t *config, int argc, char *argv[]) {
+    struct sockaddr_un addr;
+    size_t path_len = strlen(config->socket_path);
+
+    if (path_len >= sizeof(addr.sun_path)) {
+        LOG_ERROR("Socket path too long: %s", config->socket_path);
+        return GSEA_ERROR_ARGS;
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        LOG_ERROR("Failed to create socket: %s", strerror(errno));
+        return GSEA_ERROR_FILE;
+    }
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, config->socket_path, path_len);
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        LOG_ERROR("Could not reach daemon at %s: %s (is it running?)",
+                  config->socket_path, strerror(errno));
+        close(fd);
+        return GSEA_ERROR_FILE;
+    }
+
+    uint32_t count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--remote") == 0) {
+            continue;
+        }
+        if (strcmp(argv[i], "--socket") == 0) {
+            i++;
+            continue;
+        }
+        count++;
+    }
+
+    int result = sock_write_all(fd, &count, sizeof(count));
+    for (int i = 1; i < argc && result == GSEA_SUCCESS; i++) {
+        if (strcmp(argv[i], "--remote") == 0) {
+            continue;
+        }
+        if (strcmp(argv[i], "--socket") == 0) {
+            i++;
+            continue;
+        }
+        uint32_t len = (uint32_t)strlen(argv[i]);
+        result = sock_write_all(fd, &len, sizeof(len));
+        if (result == GSEA_SUCCESS) {
+            result = sock_write_all(fd, argv[i], len);
+        }
+    }
+    if (result != GSEA_SUCCESS) {
+        LOG_ERROR("Failed to send job to daemon: %s", strerror(errno));
+        close(fd);
+        return result;
+    }
+
+    int32_t reply;
+    if (sock_read_all(fd, &reply, sizeof(reply)) != GSEA_SUCCESS) {
+        LOG_ERROR("Daemon closed the connection without replying");
+        close(fd);
+        return GSEA_ERROR_FILE;
+    }
+    close(fd);
+    return (int)reply;
+}
+
 int main(int argc, char *argv[]) {
     gsea_config_t config;
     int result;
-    clock_t start_time, end_time;
-    
-    printf("=================================================\n");
-    printf("  GSEA - Gestión Segura y Eficiente de Archivos\n");
-    printf("  Universidad EAFIT - Sistemas Operativos\n");
-    printf("=================================================\n\n");
-    
+    double start_time, end_time;
+
     /* Parsear argumentos */
     result = parse_arguments(argc, argv, &config);
     if (result != GSEA_SUCCESS) {
         return EXIT_FAILURE;
     }
-    
-    /* Mostrar configuración */
-    if (config.verbose) {
-        LOG_INFO("Configuration:");
-        LOG_INFO("  Input: %s", config.input_path);
-        LOG_INFO("  Output: %s", config.output_path);
-        LOG_INFO("  Operations: %s%s%s%s",
-                 (config.operations & OP_COMPRESS) ? "COMPRESS " : "",
-                 (config.operations & OP_DECOMPRESS) ? "DECOMPRESS " : "",
-                 (config.operations & OP_ENCRYPT) ? "ENCRYPT " : "",
-                 (config.operations & OP_DECRYPT) ? "DECRYPT " : "");
-        LOG_INFO("  Threads: %d", config.num_threads);
-    }
-    
-    /* Iniciar temporizador */
-    start_time = clock();
-    
-    /* Procesar entrada */
-    if (is_directory(config.input_path)) {
-        result = process_directory(&config);
-    } else if (is_regular_file(config.input_path)) {
-        result = process_file_operations(config.input_path, config.output_path, &config);
+
+    /* Con -o - el stdout lleva los datos: clonar el descriptor para la
+       salida y mandar el fd 1 a stderr, así ningún printf ni LOG_INFO
+       contamina el stream (mismo truco que el harness de benchmarks) */
+    if (strcmp(config.output_path, "-") == 0) {
+        int data_fd = dup(STDOUT_FILENO);
+        if (data_fd < 0) {
+            LOG_ERROR("Failed to duplicate stdout: %s", strerror(errno));
+            return EXIT_FAILURE;
+        }
+        stream_set_stdout_fd(data_fd);
+        dup2(STDERR_FILENO, STDOUT_FILENO);
     } else {
-        LOG_ERROR("Input path does not exist or is not accessible: %s", 
-                  config.input_path);
+        /* El banner se omite en pipelines para no ensuciar la salida */
+        printf("=================================================\n");
+        printf("  GSEA - Gestión Segura y Eficiente de Archivos\n");
+        printf("  Universidad EAFIT - Sistemas Operativos\n");
+        printf("=================================================\n\n");
+    }
+
+    /* Modo daemon: servir trabajos por el socket hasta --daemon-stop */
+    if (config.daemon) {
+        result = daemon_serve(&config);
+        buffer_pool_drain();
+        return (result == GSEA_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    /* Cliente delgado: el trabajo (o la orden de parada) corre en el
+       daemon; aquí solo se reenvía el argv y se espera el estado */
+    if (config.remote || config.daemon_stop) {
+        result = daemon_submit(&config, argc, argv);
+        if (result == GSEA_SUCCESS) {
+            printf("Job completed by daemon\n");
+            return EXIT_SUCCESS;
+        }
         return EXIT_FAILURE;
     }
-    
+
+    /* Iniciar temporizador (pared real: clock() suma CPU entre hilos) */
+    start_time = stats_now();
+
+    result = run_job(&config, NULL);
+
+    /* Liberar la caché de buffers del hilo principal (los workers liberan
+       la suya al terminar) */
+    buffer_pool_drain();
+
     /* Calcular tiempo transcurrido */
-    end_time = clock();
-    double elapsed = ((double)(end_time - start_time)) / CLOCKS_PER_SEC;
+    end_time = stats_now();
+    double elapsed = end_time - start_time;
     
     /* Mostrar resultados */
     if (result == GSEA_SUCCESS) {
         printf("\n=================================================\n");
         printf("  Operation completed successfully!\n");
         printf("  Time elapsed: %.3f seconds\n", elapsed);
+        stats_report();
         printf("=================================================\n");
         return EXIT_SUCCESS;
     } else {
@@ -0,0 +1,384 @@
+/**
+ * @file stream.c
+ * @brief Pipeline de procesamiento por chunks con memoria acotada
+ * @details El modo clásico materializa hasta tres buffers del tamaño del
+ *          archivo completo; este módulo procesa chunks de tamaño fijo de
+ *          forma que el consumo de memoria no depende del tamaño de entrada.
+ *
+ * Formato en disco:
+ *   [magic "GSEASTR1":8][chunk_size:4 LE]
+ *   por cada chunk: [payload_size:4 LE][payload]
+ *
+ * Cada payload es el resultado de aplicar al chunk las mismas operaciones
+ * (comprimir y/o encriptar) que el modo clásico aplica al archivo entero,
+ * por lo que la ruta inversa puede desencriptar/descomprimir chunk a chunk.
+ */
+
+#include "stream.h"
+#include "file_manager.h"
+#include "compression/compression.h"
+#include "encryption/aes.h"
+#include "encryption/chacha20.h"
+#include "encryption/salsa20.h"
+#include "encryption/rc4.h"
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+static const uint8_t STREAM_MAGIC[8] = { 'G', 'S', 'E', 'A', 'S', 'T', 'R', '1' };
+
+/* Descriptor real de stdout cuando main lo redirige (-o - manda el fd 1
+   a stderr y clona el original para los datos) */
+static int stdio_out_fd = STDOUT_FILENO;
+
+void stream_set_stdout_fd(int fd) {
+    stdio_out_fd = fd;
+}
+
+bool stream_is_stream(const char *path) {
+    if (!path) {
+        return false;
+    }
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+
+    uint8_t magic[8];
+    ssize_t got = read(fd, magic, sizeof(magic));
+    close(fd);
+
+    return got == (ssize_t)sizeof(magic) &&
+           memcmp(magic, STREAM_MAGIC, sizeof(magic)) == 0;
+}
+
+/**
+ * @brief Encripta o desencripta un buffer con el algoritmo configurado
+ */
+static int crypt_buffer(const file_buffer_t *input, file_buffer_t *output,
+                        const gsea_config_t *config, bool encrypt) {
+    const uint8_t *key = (const uint8_t *)config->key;
+
+    if (config->enc_alg == ENC_AES128) {
+        return encrypt ? aes_encrypt(input, output, key, config->key_len)
+                       : aes_decrypt(input, output, key, config->key_len);
+    } else if (config->enc_alg == ENC_AES128_CTR) {
+        return encrypt ? aes_encrypt_ctr(input, output, key, config->key_len)
+                       : aes_decrypt(input, output, key, config->key_len);
+    } else if (config->enc_alg == ENC_CHACHA20) {
+        return encrypt ? chacha20_encrypt(input, output, key, config->key_len)
+                       : chacha20_decrypt(input, output, key, config->key_len);
+    } else if (config->enc_alg == ENC_SALSA20) {
+        return encrypt ? salsa20_encrypt(input, output, key, config->key_len)
+                       : salsa20_decrypt(input, output, key, config->key_len);
+    } else if (config->enc_alg == ENC_RC4) {
+        return encrypt ? rc4_encrypt(input, output, key, config->key_len)
+                       : rc4_decrypt(input, output, key, config->key_len);
+    }
+
+    LOG_ERROR("Unsupported encryption algorithm");
+    return GSEA_ERROR_ENCRYPTION;
+}
+
+/**
+ * @brief Escribe todos los bytes al descriptor (write puede ser parcial)
+ */
+static int write_all(int fd, const uint8_t *data, size_t size) {
+    size_t written = 0;
+    while (written < size) {
+        ssize_t result = write(fd, data + written, size - written);
+        if (result < 0) {
+            LOG_ERROR("Write failed: %s", strerror(errno));
+            return GSEA_ERROR_FILE;
+        }
+        written += result;
+    }
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Lee exactamente size bytes, o menos si llega fin de archivo
+ * @return Bytes leídos, o -1 en error
+ */
+static ssize_t read_full(int fd, uint8_t *data, size_t size) {
+    size_t total = 0;
+    while (total < size) {
+        ssize_t result = read(fd, data + total, size - total);
+        if (result < 0) {
+            LOG_ERROR("Read failed: %s", strerror(errno));
+            return -1;
+        }
+        if (result == 0) break; /* EOF */
+        total += result;
+    }
+    return (ssize_t)total;
+}
+
+/**
+ * @brief Aplica las operaciones directas (comprimir y/o encriptar) a un chunk
+ */
+int process_chunk_forward(const file_buffer_t *chunk, file_buffer_t *out,
+                          const gsea_config_t *config) {
+    int result;
+    file_buffer_t intermediate = {0};
+    const file_buffer_t *current = chunk;
+
+    if (config->operations & OP_COMPRESS) {
+        file_buffer_t *dest = (config->operations & OP_ENCRYPT) ? &intermediate : out;
+        result = compress_data(current, dest, config->comp_alg);
+        if (result != GSEA_SUCCESS) return result;
+        current = dest;
+    }
+
+    if (config->operations & OP_ENCRYPT) {
+        result = crypt_buffer(current, out, config, true);
+        if (current == &intermediate) {
+            free(intermediate.data);
+        }
+        if (result != GSEA_SUCCESS) return result;
+    }
+
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Aplica las operaciones inversas (desencriptar y/o descomprimir)
+ */
+int process_chunk_reverse(const file_buffer_t *chunk, file_buffer_t *out,
+                          const gsea_config_t *config) {
+    int result;
+    file_buffer_t intermediate = {0};
+    const file_buffer_t *current = chunk;
+
+    if (config->operations & OP_DECRYPT) {
+        file_buffer_t *dest = (config->operations & OP_DECOMPRESS) ? &intermediate : out;
+        result = crypt_buffer(current, dest, config, false);
+        if (result != GSEA_SUCCESS) return result;
+        current = dest;
+    }
+
+    if (config->operations & OP_DECOMPRESS) {
+        result = decompress_data(current, out, config->comp_alg);
+        if (current == &intermediate) {
+            free(intermediate.data);
+        }
+        if (result != GSEA_SUCCESS) return result;
+    }
+
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Ruta directa: archivo plano -> stream de chunks procesados
+ */
+static int stream_forward(int in_fd, int out_fd, const gsea_config_t *config) {
+    int result = GSEA_SUCCESS;
+
+    /* Header del stream: magic + tamaño de chunk */
+    uint8_t header[12];
+    memcpy(header, STREAM_MAGIC, 8);
+    uint32_t chunk_size = STREAM_CHUNK_SIZE;
+    header[8]  = (uint8_t)(chunk_size);
+    header[9]  = (uint8_t)(chunk_size >> 8);
+    header[10] = (uint8_t)(chunk_size >> 16);
+    header[11] = (uint8_t)(chunk_size >> 24);
+    result = write_all(out_fd, header, sizeof(header));
+    if (result != GSEA_SUCCESS) return result;
+
+    /* Buffer de entrada reutilizado entre chunks */
+    file_buffer_t chunk = {0};
+    chunk.data = malloc(STREAM_CHUNK_SIZE);
+    chunk.capacity = STREAM_CHUNK_SIZE;
+    if (!chunk.data) {
+        LOG_ERROR("Memory allocation failed for stream chunk");
+        return GSEA_ERROR_MEMORY;
+    }
+
+    off_t consumed = 0;  /* Rango de entrada ya leído (para el desalojo) */
+
+    while (1) {
+        ssize_t bytes_read = read_full(in_fd, chunk.data, STREAM_CHUNK_SIZE);
+        if (bytes_read < 0) {
+            result = GSEA_ERROR_FILE;
+            break;
+        }
+        if (bytes_read == 0) break; /* EOF */
+        chunk.size = (size_t)bytes_read;
+
+        /* El chunk ya está copiado: soltar sus páginas de caché de una vez
+           en lugar de dejar que 50 GB de entrada desplacen otras cargas */
+        if (file_manager_streaming_io()) {
+            posix_fadvise(in_fd, consumed, bytes_read, POSIX_FADV_DONTNEED);
+        }
+        consumed += bytes_read;
+
+        file_buffer_t processed = {0};
+        result = process_chunk_forward(&chunk, &processed, config);
+        if (result != GSEA_SUCCESS) break;
+
+        /* Frame: [payload_size:4 LE][payload] */
+        uint8_t frame_header[4];
+        uint32_t payload_size = (uint32_t)processed.size;
+        frame_header[0] = (uint8_t)(payload_size);
+        frame_header[1] = (uint8_t)(payload_size >> 8);
+        frame_header[2] = (uint8_t)(payload_size >> 16);
+        frame_header[3] = (uint8_t)(payload_size >> 24);
+
+        result = write_all(out_fd, frame_header, sizeof(frame_header));
+        if (result == GSEA_SUCCESS) {
+            result = write_all(out_fd, processed.data, processed.size);
+        }
+        free(processed.data);
+        if (result != GSEA_SUCCESS) break;
+    }
+
+    free(chunk.data);
+    return result;
+}
+
+/**
+ * @brief Ruta inversa: stream de chunks -> archivo plano
+ */
+static int stream_reverse(int in_fd, int out_fd, const gsea_config_t *config) {
+    int result = GSEA_SUCCESS;
+
+    /* Validar header del stream */
+    uint8_t header[12];
+    if (read_full(in_fd, header, sizeof(header)) != (ssize_t)sizeof(header) ||
+        memcmp(header, STREAM_MAGIC, 8) != 0) {
+        LOG_ERROR("Input is not a GSEA stream (missing magic)");
+        return GSEA_ERROR_FILE;
+    }
+
+    file_buffer_t payload = {0};
+    off_t consumed = sizeof(header);  /* Rango de entrada ya leído */
+
+    while (1) {
+        uint8_t frame_header[4];
+        ssize_t got = read_full(in_fd, frame_header, sizeof(frame_header));
+        if (got < 0) {
+            result = GSEA_ERROR_FILE;
+            break;
+        }
+        if (got == 0) break; /* EOF limpio */
+        if (got != (ssize_t)sizeof(frame_header)) {
+            LOG_ERROR("Truncated stream frame header");
+            result = GSEA_ERROR_FILE;
+            break;
+        }
+
+        uint32_t payload_size = (uint32_t)frame_header[0] |
+                                ((uint32_t)frame_header[1] << 8) |
+                                ((uint32_t)frame_header[2] << 16) |
+                                ((uint32_t)frame_header[3] << 24);
+
+        /* Reutilizar buffer de payload entre frames */
+        if (payload.capacity < payload_size) {
+            uint8_t *new_data = realloc(payload.data, payload_size);
+            if (!new_data) {
+                LOG_ERROR("Memory allocation failed for stream payload");
+                result = GSEA_ERROR_MEMORY;
+                break;
+            }
+            payload.data = new_data;
+            payload.capacity = payload_size;
+        }
+
+        if (read_full(in_fd, payload.data, payload_size) != (ssize_t)payload_size) {
+            LOG_ERROR("Truncated stream frame payload");
+            result = GSEA_ERROR_FILE;
+            break;
+        }
+        payload.size = payload_size;
+
+        /* Frame consumido: soltar sus páginas de caché */
+        if (file_manager_streaming_io()) {
+            posix_fadvise(in_fd, consumed,
+                          sizeof(frame_header) + payload_size,
+                          POSIX_FADV_DONTNEED);
+        }
+        consumed += sizeof(frame_header) + payload_size;
+
+        file_buffer_t restored = {0};
+        result = process_chunk_reverse(&payload, &restored, config);
+        if (result != GSEA_SUCCESS) break;
+
+        result = write_all(out_fd, restored.data, restored.size);
+        free(restored.data);
+        if (result != GSEA_SUCCESS) break;
+    }
+
+    free(payload.data);
+    return result;
+}
+
+/**
+ * @brief Procesa un archivo por chunks con memoria acotada
+ */
+int process_file_streaming(const char *input_path, const char *output_path,
+                           const gsea_config_t *config) {
+    if (!input_path || !output_path || !config) {
+        LOG_ERROR("Invalid parameters for process_file_streaming");
+        return GSEA_ERROR_ARGS;
+    }
+
+    bool forward = (config->operations & (OP_COMPRESS | OP_ENCRYPT)) != 0;
+
+    /* "-" designa stdin/stdout: composición en pipelines de shell sin
+       archivos intermedios. El flujo por chunks ya solo lee y escribe en
+       orden, así que no importa que no sean seekables */
+    bool in_std = strcmp(input_path, "-") == 0;
+    bool out_std = strcmp(output_path, "-") == 0;
+
+    if (config->verbose) {
+        LOG_INFO("Streaming: %s -> %s (%u KB chunks)",
+                 input_path, output_path, STREAM_CHUNK_SIZE / 1024);
+    }
+
+    int in_fd = in_std ? STDIN_FILENO : open(input_path, O_RDONLY);
+    if (in_fd < 0) {
+        LOG_ERROR("Failed to open file '%s': %s", input_path, strerror(errno));
+        return GSEA_ERROR_FILE;
+    }
+
+    int out_fd = out_std ? stdio_out_fd
+                         : open(output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out_fd < 0) {
+        LOG_ERROR("Failed to create file '%s': %s", output_path, strerror(errno));
+        if (!in_std) close(in_fd);
+        return GSEA_ERROR_FILE;
+    }
+
+    /* Lectura de una sola pasada: readahead agresivo (no aplica a pipes) */
+    if (file_manager_streaming_io() && !in_std) {
+        posix_fadvise(in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+
+    int result = forward ? stream_forward(in_fd, out_fd, config)
+                         : stream_reverse(in_fd, out_fd, config);
+
+    if (result == GSEA_SUCCESS && !out_std &&
+        file_manager_get_fsync_policy() == FSYNC_PER_FILE && fsync(out_fd) < 0) {
+        LOG_ERROR("Failed to sync file '%s': %s", output_path, strerror(errno));
+    }
+
+    /* Soltar las páginas de la salida (writeback previo si la política de
+       fsync no lo hizo: DONTNEED solo desaloja páginas limpias) */
+    if (result == GSEA_SUCCESS && !out_std && file_manager_streaming_io()) {
+        if (file_manager_get_fsync_policy() != FSYNC_PER_FILE &&
+            fdatasync(out_fd) < 0) {
+            LOG_DEBUG("fdatasync before cache drop failed for '%s': %s",
+                      output_path, strerror(errno));
+        }
+        posix_fadvise(out_fd, 0, 0, POSIX_FADV_DONTNEED);
+    }
+
+    if (!in_std) close(in_fd);
+    if (!out_std) close(out_fd);
+    return result;
+}
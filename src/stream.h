@@ -0,0 +1,61 @@
+/**
+ * @file stream.h
+ * @brief Interfaz del pipeline de procesamiento por chunks (streaming)
+ */
+
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "common.h"
+
+/* Tamaño de chunk del pipeline streaming (4 MB) */
+#define STREAM_CHUNK_SIZE (4u * 1024u * 1024u)
+
+/**
+ * @brief Procesa un archivo por chunks con memoria acotada
+ * @details El archivo fluye por etapas leer -> comprimir -> encriptar ->
+ *          escribir en chunks de STREAM_CHUNK_SIZE, manteniendo solo unos
+ *          pocos chunks en memoria. La salida usa un framing por chunk que
+ *          permite desencriptar/descomprimir también en streaming.
+ * @param input_path Ruta del archivo de entrada
+ * @param output_path Ruta del archivo de salida
+ * @param config Configuración global (operaciones, algoritmos, clave)
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int process_file_streaming(const char *input_path, const char *output_path,
+                           const gsea_config_t *config);
+
+/**
+ * @brief Detecta si un archivo es un contenedor streaming (magic GSEASTR1)
+ * @details Permite que la ruta inversa entre al pipeline de chunks aunque
+ *          el usuario no pase --stream (las salidas de -o - también usan
+ *          este formato).
+ * @param path Ruta del archivo a inspeccionar
+ * @return true si los primeros 8 bytes son el magic del formato
+ */
+bool stream_is_stream(const char *path);
+
+/**
+ * @brief Fija el descriptor de datos para la salida "-" (stdout)
+ * @details main clona el fd 1 y redirige stdout a stderr cuando la salida
+ *          es un pipe, para que los logs no contaminen el stream de datos;
+ *          aquí registra el clon por el que realmente salen los datos.
+ * @param fd Descriptor clonado del stdout original
+ */
+void stream_set_stdout_fd(int fd);
+
+/**
+ * @brief Aplica las operaciones directas (comprimir y/o encriptar) a un buffer
+ * @details Compartido con el modo archivo empaquetado, que aplica el mismo
+ *          pipeline a cada entrada del contenedor
+ */
+int process_chunk_forward(const file_buffer_t *chunk, file_buffer_t *out,
+                          const gsea_config_t *config);
+
+/**
+ * @brief Aplica las operaciones inversas (desencriptar y/o descomprimir)
+ */
+int process_chunk_reverse(const file_buffer_t *chunk, file_buffer_t *out,
+                          const gsea_config_t *config);
+
+#endif /* STREAM_H */
@@ -0,0 +1,128 @@
+/**
+ * @file arena.c
+ * @brief Asignador de arena (bump) para metadatos de un trabajo
+ */
+
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* Bloque de la arena: la memoria útil sigue inmediatamente al header */
+typedef struct arena_chunk {
+    struct arena_chunk *next;
+    size_t used;
+    size_t capacity;
+} arena_chunk_t;
+
+struct arena {
+    arena_chunk_t *head;    /* Bloque activo (con espacio libre al frente) */
+    size_t chunk_size;
+};
+
+/**
+ * @brief Asigna un bloque nuevo con capacity bytes útiles
+ */
+static arena_chunk_t *chunk_create(size_t capacity) {
+    arena_chunk_t *chunk = malloc(sizeof(arena_chunk_t) + capacity);
+    if (!chunk) {
+        return NULL;
+    }
+    chunk->next = NULL;
+    chunk->used = 0;
+    chunk->capacity = capacity;
+    return chunk;
+}
+
+/**
+ * @brief Crea una arena con bloques del tamaño dado
+ */
+arena_t *arena_create(size_t chunk_size) {
+    arena_t *arena = malloc(sizeof(arena_t));
+    if (!arena) {
+        LOG_ERROR("Failed to allocate arena");
+        return NULL;
+    }
+
+    arena->chunk_size = (chunk_size > 0) ? chunk_size
+                                         : ARENA_DEFAULT_CHUNK_SIZE;
+    arena->head = chunk_create(arena->chunk_size);
+    if (!arena->head) {
+        LOG_ERROR("Failed to allocate initial arena chunk");
+        free(arena);
+        return NULL;
+    }
+
+    return arena;
+}
+
+/**
+ * @brief Asigna size bytes de la arena (alineados a 8)
+ */
+void *arena_alloc(arena_t *arena, size_t size) {
+    if (!arena || size == 0) {
+        return NULL;
+    }
+
+    size = ALIGN_UP(size, 8);
+
+    /* Peticiones mayores que el bloque: bloque dedicado detrás del activo,
+       para no desperdiciar el espacio libre del frente */
+    if (size > arena->chunk_size) {
+        arena_chunk_t *big = chunk_create(size);
+        if (!big) {
+            LOG_ERROR("Failed to allocate oversized arena chunk (%zu bytes)", size);
+            return NULL;
+        }
+        big->used = size;
+        big->next = arena->head->next;
+        arena->head->next = big;
+        return (uint8_t *)(big + 1);
+    }
+
+    if (arena->head->used + size > arena->head->capacity) {
+        arena_chunk_t *chunk = chunk_create(arena->chunk_size);
+        if (!chunk) {
+            LOG_ERROR("Failed to grow arena");
+            return NULL;
+        }
+        chunk->next = arena->head;
+        arena->head = chunk;
+    }
+
+    void *ptr = (uint8_t *)(arena->head + 1) + arena->head->used;
+    arena->head->used += size;
+    return ptr;
+}
+
+/**
+ * @brief Copia una cadena dentro de la arena (longitud exacta)
+ */
+char *arena_strdup(arena_t *arena, const char *str) {
+    if (!arena || !str) {
+        return NULL;
+    }
+
+    size_t len = strlen(str) + 1;
+    char *copy = arena_alloc(arena, len);
+    if (copy) {
+        memcpy(copy, str, len);
+    }
+    return copy;
+}
+
+/**
+ * @brief Libera la arena completa con todos sus bloques
+ */
+void arena_destroy(arena_t *arena) {
+    if (!arena) {
+        return;
+    }
+
+    arena_chunk_t *chunk = arena->head;
+    while (chunk) {
+        arena_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    free(arena);
+}
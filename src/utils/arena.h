@@ -0,0 +1,47 @@
+/**
+ * @file arena.h
+ * @brief Asignador de arena (bump) para metadatos de un trabajo
+ * @details Asignaciones pequeñas y de vida compartida — rutas, listados,
+ *          argumentos de tarea — salen de bloques grandes con un simple
+ *          avance de puntero, sin free individual: la arena completa se
+ *          libera al terminar el trabajo. Evita cientos de miles de
+ *          llamadas al asignador en árboles grandes.
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "../common.h"
+
+typedef struct arena arena_t;
+
+/* Tamaño de bloque por defecto para arena_create(0) */
+#define ARENA_DEFAULT_CHUNK_SIZE (64u * 1024u)
+
+/**
+ * @brief Crea una arena con bloques del tamaño dado
+ * @param chunk_size Tamaño de cada bloque (0 usa el valor por defecto)
+ * @return Arena creada o NULL si falla la asignación
+ */
+arena_t *arena_create(size_t chunk_size);
+
+/**
+ * @brief Asigna size bytes de la arena (alineados a 8)
+ * @details Las peticiones mayores que el bloque reciben un bloque propio.
+ *          No hay free individual: la memoria vive hasta arena_destroy.
+ * @return Puntero a la memoria o NULL si falla
+ */
+void *arena_alloc(arena_t *arena, size_t size);
+
+/**
+ * @brief Copia una cadena dentro de la arena (longitud exacta)
+ * @return Copia terminada en NUL o NULL si falla
+ */
+char *arena_strdup(arena_t *arena, const char *str);
+
+/**
+ * @brief Libera la arena completa con todos sus bloques
+ */
+void arena_destroy(arena_t *arena);
+
+#endif /* ARENA_H */
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
+#include <unistd.h>
 
 /**
  * @brief Imprime mensaje de uso del programa
@@ -20,12 +21,27 @@ static void print_usage(const char *program_name) {
     printf("  -d                    Decompress data\n");
     printf("  -e                    Encrypt data\n");
     printf("  -u                    Decrypt data\n");
-    printf("  --comp-alg ALG        Compression algorithm (lz77, huffman, rle, lzw)\n");
-    printf("  --enc-alg ALG         Encryption algorithm (aes128, chacha20, salsa20, rc4, des, vigenere)\n");
-    printf("  -i PATH               Input file or directory\n");
-    printf("  -o PATH               Output file or directory\n");
+    printf("  --comp-alg ALG        Compression algorithm (lz77, huffman, rle, lzw, auto, store)\n");
+    printf("  --comp-level NUM      Compression level 1-9 (default: 6, lz77 only)\n");
+    printf("  --enc-alg ALG         Encryption algorithm (aes128, aes128-ctr, chacha20, salsa20, rc4, des, vigenere)\n");
+    printf("  -i PATH               Input file or directory (- for stdin)\n");
+    printf("  -o PATH               Output file or directory (- for stdout)\n");
     printf("  -k KEY                Encryption/Decryption key\n");
-    printf("  -t NUM                Number of threads (default: 4)\n");
+    printf("  -t NUM                Number of threads (default: detected cores)\n");
+    printf("  --stream              Process in fixed-size chunks (bounded memory)\n");
+    printf("  --streaming-io        Advise the kernel to drop consumed page cache (fadvise)\n");
+    printf("  --io-engine ENGINE    I/O engine (posix, uring; default: posix)\n");
+    printf("  --fsync POLICY        Durability policy (per-file, end, none; default: per-file)\n");
+    printf("  --stats               Report per-stage timing breakdown\n");
+    printf("  --recursive           Recurse into subdirectories (mirrors tree in output)\n");
+    printf("  --dict FILE           Preset dictionary for lz77/lzw (needed again to decompress)\n");
+    printf("  --incremental         Skip unchanged files using a manifest in the output dir\n");
+    printf("  --force               With --incremental: reprocess even unchanged files\n");
+    printf("  --extract-range O:L   With -d: extract L bytes at uncompressed offset O\n");
+    printf("  --daemon              Run as a daemon serving jobs over a unix socket\n");
+    printf("  --remote              Submit this job to a running daemon\n");
+    printf("  --daemon-stop         Ask the running daemon to shut down\n");
+    printf("  --socket PATH         Daemon socket path (default: /tmp/gsea.sock)\n");
     printf("  -v                    Verbose output\n");
     printf("  -h, --help            Show this help message\n\n");
     printf("Examples:\n");
@@ -53,6 +69,12 @@ static int parse_compression_algorithm(const char *alg_name,
     } else if (strcmp(alg_name, "lzw") == 0) {
         *alg = COMP_LZW;
         return GSEA_SUCCESS;
+    } else if (strcmp(alg_name, "auto") == 0) {
+        *alg = COMP_AUTO;
+        return GSEA_SUCCESS;
+    } else if (strcmp(alg_name, "store") == 0) {
+        *alg = COMP_STORE;
+        return GSEA_SUCCESS;
     } else {
         LOG_ERROR("Unknown compression algorithm: %s", alg_name);
         return GSEA_ERROR_ARGS;
@@ -67,6 +89,9 @@ static int parse_encryption_algorithm(const char *alg_name,
     if (strcmp(alg_name, "aes128") == 0 || strcmp(alg_name, "aes") == 0) {
         *alg = ENC_AES128;
         return GSEA_SUCCESS;
+    } else if (strcmp(alg_name, "aes128-ctr") == 0 || strcmp(alg_name, "aes-ctr") == 0) {
+        *alg = ENC_AES128_CTR;
+        return GSEA_SUCCESS;
     } else if (strcmp(alg_name, "chacha20") == 0 || strcmp(alg_name, "chacha") == 0) {
         *alg = ENC_CHACHA20;
         return GSEA_SUCCESS;
@@ -129,10 +154,15 @@ int parse_arguments(int argc, char *argv[], gsea_config_t *config) {
     memset(config, 0, sizeof(gsea_config_t));
     config->operations = OP_NONE;
     config->comp_alg = COMP_LZ77;  /* Default */
+    config->comp_level = 6;         /* Default (LZ77_DEFAULT_LEVEL) */
     config->enc_alg = ENC_AES128;  /* Default */
-    config->num_threads = 4;        /* Default */
+    /* Por defecto, tantos hilos como núcleos detectados */
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    config->num_threads = (cores > 0) ? (int)MIN(cores, MAX_THREADS) : 4;
     config->verbose = false;
-    
+    config->fsync_policy = FSYNC_PER_FILE;
+    strncpy(config->socket_path, "/tmp/gsea.sock", MAX_PATH_LENGTH - 1);
+
     /* Parsear argumentos */
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
@@ -217,6 +247,98 @@ int parse_arguments(int argc, char *argv[], gsea_config_t *config) {
                 }
             }
         }
+        else if (strcmp(argv[i], "--stream") == 0) {
+            config->stream = true;
+        }
+        else if (strcmp(argv[i], "--streaming-io") == 0) {
+            config->streaming_io = true;
+        }
+        else if (strcmp(argv[i], "--stats") == 0) {
+            config->stats = true;
+        }
+        else if (strcmp(argv[i], "--recursive") == 0) {
+            config->recursive = true;
+        }
+        else if (strcmp(argv[i], "--incremental") == 0) {
+            config->incremental = true;
+        }
+        else if (strcmp(argv[i], "--force") == 0) {
+            config->force = true;
+        }
+        else if (strcmp(argv[i], "--daemon") == 0) {
+            config->daemon = true;
+        }
+        else if (strcmp(argv[i], "--remote") == 0) {
+            config->remote = true;
+        }
+        else if (strcmp(argv[i], "--daemon-stop") == 0) {
+            config->daemon_stop = true;
+        }
+        else if (strcmp(argv[i], "--socket") == 0) {
+            if (i + 1 >= argc) {
+                LOG_ERROR("Missing argument for --socket");
+                return GSEA_ERROR_ARGS;
+            }
+            strncpy(config->socket_path, argv[++i], MAX_PATH_LENGTH - 1);
+        }
+        else if (strcmp(argv[i], "--dict") == 0) {
+            if (i + 1 >= argc) {
+                LOG_ERROR("Missing argument for --dict");
+                return GSEA_ERROR_ARGS;
+            }
+            strncpy(config->dict_path, argv[++i], MAX_PATH_LENGTH - 1);
+        }
+        else if (strcmp(argv[i], "--extract-range") == 0) {
+            if (i + 1 >= argc) {
+                LOG_ERROR("Missing argument for --extract-range");
+                return GSEA_ERROR_ARGS;
+            }
+            i++;
+            char *sep = strchr(argv[i], ':');
+            if (!sep || sep == argv[i] || *(sep + 1) == '\0') {
+                LOG_ERROR("Invalid range '%s' (expected offset:length)", argv[i]);
+                return GSEA_ERROR_ARGS;
+            }
+            config->range_offset = strtoull(argv[i], NULL, 10);
+            config->range_length = strtoull(sep + 1, NULL, 10);
+            if (config->range_length == 0) {
+                LOG_ERROR("Range length must be greater than zero");
+                return GSEA_ERROR_ARGS;
+            }
+            config->extract_range = true;
+        }
+        else if (strcmp(argv[i], "--io-engine") == 0) {
+            if (i + 1 >= argc) {
+                LOG_ERROR("Missing argument for --io-engine");
+                return GSEA_ERROR_ARGS;
+            }
+            i++;
+            if (strcmp(argv[i], "uring") == 0) {
+                config->io_uring = true;
+            } else if (strcmp(argv[i], "posix") == 0) {
+                config->io_uring = false;
+            } else {
+                LOG_ERROR("Unknown I/O engine: %s", argv[i]);
+                return GSEA_ERROR_ARGS;
+            }
+        }
+        else if (strcmp(argv[i], "--fsync") == 0) {
+            if (i + 1 >= argc) {
+                LOG_ERROR("Missing argument for --fsync");
+                return GSEA_ERROR_ARGS;
+            }
+            i++;
+            if (strcmp(argv[i], "per-file") == 0) {
+                config->fsync_policy = FSYNC_PER_FILE;
+            } else if (strcmp(argv[i], "end") == 0) {
+                config->fsync_policy = FSYNC_END;
+            } else if (strcmp(argv[i], "none") == 0) {
+                config->fsync_policy = FSYNC_NONE;
+            } else {
+                LOG_ERROR("Unknown fsync policy: %s", argv[i]);
+                return GSEA_ERROR_ARGS;
+            }
+        }
         else if (strcmp(argv[i], "--comp-alg") == 0) {
             if (i + 1 >= argc) {
                 LOG_ERROR("Missing argument for --comp-alg");
@@ -226,6 +348,17 @@ int parse_arguments(int argc, char *argv[], gsea_config_t *config) {
                 return GSEA_ERROR_ARGS;
             }
         }
+        else if (strcmp(argv[i], "--comp-level") == 0) {
+            if (i + 1 >= argc) {
+                LOG_ERROR("Missing argument for --comp-level");
+                return GSEA_ERROR_ARGS;
+            }
+            config->comp_level = atoi(argv[++i]);
+            if (config->comp_level < 1 || config->comp_level > 9) {
+                LOG_ERROR("Invalid compression level: %d (must be 1-9)", config->comp_level);
+                return GSEA_ERROR_ARGS;
+            }
+        }
         else if (strcmp(argv[i], "--enc-alg") == 0) {
             if (i + 1 >= argc) {
                 LOG_ERROR("Missing argument for --enc-alg");
@@ -242,6 +375,16 @@ int parse_arguments(int argc, char *argv[], gsea_config_t *config) {
         next_arg:;
     }
     
+    /* El daemon no lleva trabajo propio: solo sirve los que lleguen por el
+       socket. --daemon-stop tampoco; el resto de validaciones no aplica */
+    if (config->daemon || config->daemon_stop) {
+        if (config->daemon && config->daemon_stop) {
+            LOG_ERROR("--daemon and --daemon-stop are mutually exclusive");
+            return GSEA_ERROR_ARGS;
+        }
+        return GSEA_SUCCESS;
+    }
+
     /* Validar configuración */
     if (config->operations == OP_NONE) {
         LOG_ERROR("No operation specified. Use -c, -d, -e, or -u");
@@ -269,6 +412,42 @@ int parse_arguments(int argc, char *argv[], gsea_config_t *config) {
         return GSEA_ERROR_ARGS;
     }
     
+    /* La extracción de rango opera sobre un stream comprimido sin capas
+       adicionales: solo tiene sentido con -d a solas */
+    if (config->extract_range && config->operations != OP_DECOMPRESS) {
+        LOG_ERROR("--extract-range requires -d (decompress) as the only operation");
+        return GSEA_ERROR_ARGS;
+    }
+
+    /* stdin/stdout ("-") van por el pipeline de chunks secuencial: las
+       operaciones que necesitan seeks o rutas reales quedan fuera */
+    if ((strcmp(config->input_path, "-") == 0 ||
+         strcmp(config->output_path, "-") == 0) &&
+        (config->extract_range || config->recursive)) {
+        LOG_ERROR("stdin/stdout streams cannot be combined with "
+                  "--extract-range or --recursive");
+        return GSEA_ERROR_ARGS;
+    }
+
+    /* El contenedor .gsea empaqueta el listado plano del directorio de
+       entrada: aceptar --recursive dejaría fuera los subdirectorios sin
+       avisar */
+    size_t out_len = strlen(config->output_path);
+    if (config->recursive && out_len > 5 &&
+        strcmp(config->output_path + out_len - 5, ".gsea") == 0) {
+        LOG_ERROR("--recursive cannot be combined with a .gsea archive "
+                  "output (the container packs the flat top-level listing)");
+        return GSEA_ERROR_ARGS;
+    }
+
+    /* Los fds estándar del cliente no viajan por el socket del daemon */
+    if (config->remote &&
+        (strcmp(config->input_path, "-") == 0 ||
+         strcmp(config->output_path, "-") == 0)) {
+        LOG_ERROR("--remote jobs require real paths (no stdin/stdout)");
+        return GSEA_ERROR_ARGS;
+    }
+
     /* Verificar que se proporcione clave para encriptación/desencriptación */
     if ((config->operations & (OP_ENCRYPT | OP_DECRYPT)) && config->key_len == 0) {
         LOG_ERROR("Encryption key (-k) is required for encryption/decryption operations");
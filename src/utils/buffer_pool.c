@@ -0,0 +1,156 @@
+/**
+ * @file buffer_pool.c
+ * @brief Implementación del pool de buffers por hilo
+ * @details La caché es un arreglo fijo de slots {data, capacity} en
+ *          almacenamiento thread-local: acquire y release nunca toman
+ *          locks ni tocan estado compartido. La limpieza al terminar cada
+ *          hilo se engancha con un destructor de pthread_key para no
+ *          acoplar el thread pool a este módulo.
+ */
+
+#include "buffer_pool.h"
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <pthread.h>
+
+/* ==============================
+ * Caché por hilo
+ * ============================== */
+
+/* Tres etapas por archivo + un slot de holgura */
+#define BUFFER_POOL_SLOTS 4
+
+typedef struct {
+    uint8_t *data;
+    size_t capacity;
+} pool_slot_t;
+
+static _Thread_local pool_slot_t pool_slots[BUFFER_POOL_SLOTS];
+static _Thread_local bool pool_registered = false;
+
+static pthread_key_t pool_key;
+static pthread_once_t pool_key_once = PTHREAD_ONCE_INIT;
+
+static void pool_thread_exit(void *arg) {
+    pool_slot_t *slots = (pool_slot_t *)arg;
+    for (int i = 0; i < BUFFER_POOL_SLOTS; i++) {
+        free(slots[i].data);
+        slots[i].data = NULL;
+        slots[i].capacity = 0;
+    }
+}
+
+static void pool_key_create(void) {
+    pthread_key_create(&pool_key, pool_thread_exit);
+}
+
+/* Registra la caché del hilo para liberarla cuando el hilo termine */
+static void pool_register(void) {
+    if (!pool_registered) {
+        pthread_once(&pool_key_once, pool_key_create);
+        pthread_setspecific(pool_key, pool_slots);
+        pool_registered = true;
+    }
+}
+
+/* ==============================
+ * API pública
+ * ============================== */
+
+int buffer_reserve(file_buffer_t *buffer, size_t capacity) {
+    if (!buffer || buffer->mapped) {
+        return GSEA_ERROR_ARGS;
+    }
+    if (buffer->capacity >= capacity && buffer->data) {
+        return GSEA_SUCCESS;
+    }
+    uint8_t *new_data = realloc(buffer->data, capacity ? capacity : 1);
+    if (!new_data) {
+        LOG_ERROR("Failed to reserve %zu bytes for buffer", capacity);
+        return GSEA_ERROR_MEMORY;
+    }
+    buffer->data = new_data;
+    buffer->capacity = capacity ? capacity : 1;
+    return GSEA_SUCCESS;
+}
+
+int buffer_pool_acquire(file_buffer_t *buffer, size_t size_hint) {
+    if (!buffer) {
+        return GSEA_ERROR_ARGS;
+    }
+    pool_register();
+
+    /* Mejor ajuste: el slot más chico que ya cubre la pista; si ninguno
+       alcanza, el más grande disponible (buffer_reserve lo crece) */
+    int best = -1;
+    for (int i = 0; i < BUFFER_POOL_SLOTS; i++) {
+        if (!pool_slots[i].data) {
+            continue;
+        }
+        if (pool_slots[i].capacity >= size_hint) {
+            if (best < 0 || pool_slots[i].capacity < pool_slots[best].capacity) {
+                best = i;
+            }
+        } else if (best < 0 || (pool_slots[best].capacity < size_hint &&
+                                pool_slots[i].capacity > pool_slots[best].capacity)) {
+            best = i;
+        }
+    }
+
+    buffer->size = 0;
+    buffer->mapped = false;
+    if (best >= 0) {
+        buffer->data = pool_slots[best].data;
+        buffer->capacity = pool_slots[best].capacity;
+        pool_slots[best].data = NULL;
+        pool_slots[best].capacity = 0;
+    } else {
+        buffer->data = NULL;
+        buffer->capacity = 0;
+    }
+
+    if (size_hint > 0) {
+        return buffer_reserve(buffer, size_hint);
+    }
+    return GSEA_SUCCESS;
+}
+
+void buffer_pool_release(file_buffer_t *buffer) {
+    if (!buffer || !buffer->data) {
+        return;
+    }
+    if (buffer->mapped) {
+        munmap(buffer->data, buffer->capacity);
+    } else {
+        pool_register();
+
+        /* Guardar en un slot vacío; si no hay, desplazar el más chico */
+        int target = -1;
+        for (int i = 0; i < BUFFER_POOL_SLOTS; i++) {
+            if (!pool_slots[i].data) {
+                target = i;
+                break;
+            }
+            if (target < 0 || pool_slots[i].capacity < pool_slots[target].capacity) {
+                target = i;
+            }
+        }
+        if (pool_slots[target].data &&
+            pool_slots[target].capacity >= buffer->capacity) {
+            free(buffer->data);    /* El cacheado es mejor: descartar este */
+        } else {
+            free(pool_slots[target].data);
+            pool_slots[target].data = buffer->data;
+            pool_slots[target].capacity = buffer->capacity;
+        }
+    }
+    buffer->data = NULL;
+    buffer->size = 0;
+    buffer->capacity = 0;
+    buffer->mapped = false;
+}
+
+void buffer_pool_drain(void) {
+    pool_thread_exit(pool_slots);
+}
@@ -0,0 +1,59 @@
+/**
+ * @file buffer_pool.h
+ * @brief Pool de buffers reutilizables por hilo para el pipeline
+ * @details Cada archivo procesado pasa por al menos tres file_buffer_t
+ *          (entrada, intermedio, salida) que antes se asignaban y liberaban
+ *          por completo en cada iteración. El pool guarda el almacenamiento
+ *          de buffers liberados en una caché por hilo (thread-local, sin
+ *          locks) y lo reutiliza en el siguiente archivo del mismo worker,
+ *          eliminando el churn de malloc/free en trabajos con muchos
+ *          archivos pequeños. buffer_reserve() complementa el pool: los
+ *          codecs dimensionan su salida una sola vez por adelantado en vez
+ *          de crecer por realloc repetido.
+ */
+
+#ifndef BUFFER_POOL_H
+#define BUFFER_POOL_H
+
+#include "../common.h"
+
+/**
+ * @brief Garantiza que el buffer tenga al menos la capacidad indicada
+ * @details Reutiliza el almacenamiento existente si alcanza; si no, crece
+ *          con realloc preservando los primeros size bytes. No aplica a
+ *          buffers mapeados con mmap.
+ * @param buffer Buffer a dimensionar (data puede ser NULL)
+ * @param capacity Capacidad mínima requerida en bytes
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int buffer_reserve(file_buffer_t *buffer, size_t capacity);
+
+/**
+ * @brief Obtiene un buffer de la caché del hilo actual
+ * @details Entrega el slot cacheado que mejor ajuste a size_hint (el tamaño
+ *          del archivo según stat es una buena pista) y lo crece si hace
+ *          falta. El buffer sale vacío (size 0) y listo para usar.
+ * @param buffer Buffer de destino (se sobreescribe; no debe poseer data)
+ * @param size_hint Capacidad esperada en bytes (0 si se desconoce)
+ * @return GSEA_SUCCESS si fue exitoso, código de error en caso contrario
+ */
+int buffer_pool_acquire(file_buffer_t *buffer, size_t size_hint);
+
+/**
+ * @brief Devuelve el almacenamiento de un buffer a la caché del hilo
+ * @details Los buffers mapeados se liberan con munmap como siempre; los de
+ *          heap se guardan para el siguiente acquire del mismo hilo (o se
+ *          liberan si la caché está llena). Deja el buffer en cero.
+ * @param buffer Buffer a devolver (puede estar vacío)
+ */
+void buffer_pool_release(file_buffer_t *buffer);
+
+/**
+ * @brief Libera la caché del hilo actual
+ * @details Los hilos del pool la liberan automáticamente al terminar (vía
+ *          destructor de pthread_key); el hilo principal puede llamarla
+ *          explícitamente antes de salir.
+ */
+void buffer_pool_drain(void);
+
+#endif /* BUFFER_POOL_H */
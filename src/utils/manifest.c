@@ -0,0 +1,264 @@
+/**
+ * @file manifest.c
+ * @brief Implementación del manifiesto de modo incremental
+ */
+
+#include "manifest.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <pthread.h>
+
+/* Entrada por archivo de entrada */
+typedef struct {
+    char *path;        /* Ruta del archivo de entrada (clave) */
+    off_t size;        /* Tamaño en bytes al procesarlo */
+    time_t mtime;      /* mtime al procesarlo */
+    uint64_t hash;     /* FNV-1a de 64 bits del contenido */
+} manifest_entry_t;
+
+/* Tabla hash con direccionamiento abierto indexada por ruta. Capacidad
+   en potencia de dos y factor de carga <= 0.5, como el índice de LZW */
+struct manifest {
+    manifest_entry_t *entries;
+    size_t capacity;
+    size_t count;
+    pthread_mutex_t lock;  /* Protege la tabla: record puede hacerla crecer
+                              mientras otros hilos hacen checks */
+};
+
+#define MANIFEST_INITIAL_CAPACITY 1024
+
+uint64_t manifest_hash(const uint8_t *data, size_t size) {
+    uint64_t h = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++) {
+        h ^= data[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+/* FNV-1a de la ruta, para indexar la tabla */
+static uint64_t path_hash(const char *path) {
+    return manifest_hash((const uint8_t *)path, strlen(path));
+}
+
+/**
+ * @brief Busca el slot de una ruta (ocupado por ella, o el primer libre)
+ */
+static manifest_entry_t *find_slot(const manifest_t *m, const char *path) {
+    size_t slot = path_hash(path) & (m->capacity - 1);
+    while (m->entries[slot].path) {
+        if (strcmp(m->entries[slot].path, path) == 0) {
+            break;
+        }
+        slot = (slot + 1) & (m->capacity - 1);
+    }
+    return &m->entries[slot];
+}
+
+/**
+ * @brief Duplica la capacidad reinsertando todas las entradas
+ */
+static int grow(manifest_t *m) {
+    size_t new_capacity = m->capacity * 2;
+    manifest_entry_t *new_entries = calloc(new_capacity,
+                                           sizeof(manifest_entry_t));
+    if (!new_entries) {
+        return GSEA_ERROR_MEMORY;
+    }
+
+    manifest_entry_t *old_entries = m->entries;
+    size_t old_capacity = m->capacity;
+    m->entries = new_entries;
+    m->capacity = new_capacity;
+
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_entries[i].path) {
+            *find_slot(m, old_entries[i].path) = old_entries[i];
+        }
+    }
+    free(old_entries);
+    return GSEA_SUCCESS;
+}
+
+/**
+ * @brief Inserta o refresca una entrada (sin lock: caller lo maneja)
+ */
+static int put(manifest_t *m, const char *path, off_t size, time_t mtime,
+               uint64_t hash) {
+    if (m->count * 2 >= m->capacity && grow(m) != GSEA_SUCCESS) {
+        return GSEA_ERROR_MEMORY;
+    }
+
+    manifest_entry_t *entry = find_slot(m, path);
+    if (!entry->path) {
+        entry->path = strdup(path);
+        if (!entry->path) {
+            return GSEA_ERROR_MEMORY;
+        }
+        m->count++;
+    }
+    entry->size = size;
+    entry->mtime = mtime;
+    entry->hash = hash;
+    return GSEA_SUCCESS;
+}
+
+manifest_t *manifest_load(const char *output_dir) {
+    manifest_t *m = calloc(1, sizeof(manifest_t));
+    if (!m) {
+        return NULL;
+    }
+    m->capacity = MANIFEST_INITIAL_CAPACITY;
+    m->entries = calloc(m->capacity, sizeof(manifest_entry_t));
+    if (!m->entries) {
+        free(m);
+        return NULL;
+    }
+    pthread_mutex_init(&m->lock, NULL);
+
+    char path[MAX_PATH_LENGTH];
+    int written = snprintf(path, sizeof(path), "%s/%s", output_dir,
+                           MANIFEST_FILENAME);
+    if (written < 0 || written >= (int)sizeof(path)) {
+        return m;  /* Ruta inválida: se comporta como primera corrida */
+    }
+
+    FILE *f = fopen(path, "r");
+    if (!f) {
+        return m;  /* Sin manifiesto previo: primera corrida */
+    }
+
+    /* Formato por línea: <size> <mtime> <hash-hex> <ruta hasta fin de línea> */
+    char line[MAX_PATH_LENGTH + 128];
+    while (fgets(line, sizeof(line), f)) {
+        long long size, mtime;
+        unsigned long long hash;
+        int consumed = 0;
+        if (sscanf(line, "%lld %lld %llx %n", &size, &mtime, &hash,
+                   &consumed) != 3 || consumed == 0) {
+            continue;  /* Línea corrupta: se ignora y se reprocesará */
+        }
+        char *entry_path = line + consumed;
+        entry_path[strcspn(entry_path, "\n")] = '\0';
+        if (entry_path[0] == '\0') {
+            continue;
+        }
+        put(m, entry_path, (off_t)size, (time_t)mtime, (uint64_t)hash);
+    }
+
+    fclose(f);
+    return m;
+}
+
+bool manifest_check(manifest_t *m, const char *path, off_t size,
+                    time_t mtime) {
+    if (!m) {
+        return false;
+    }
+    pthread_mutex_lock(&m->lock);
+    const manifest_entry_t *entry = find_slot(m, path);
+    bool match = entry->path && entry->size == size && entry->mtime == mtime;
+    pthread_mutex_unlock(&m->lock);
+    return match;
+}
+
+bool manifest_check_hash(manifest_t *m, const char *path, off_t size,
+                         uint64_t hash) {
+    if (!m) {
+        return false;
+    }
+    pthread_mutex_lock(&m->lock);
+    const manifest_entry_t *entry = find_slot(m, path);
+    bool match = entry->path && entry->size == size && entry->hash == hash;
+    pthread_mutex_unlock(&m->lock);
+    return match;
+}
+
+void manifest_record(manifest_t *m, const char *path, off_t size,
+                     uint64_t hash) {
+    if (!m) {
+        return;
+    }
+
+    struct stat st;
+    time_t mtime = (stat(path, &st) == 0) ? st.st_mtime : 0;
+
+    pthread_mutex_lock(&m->lock);
+    if (put(m, path, size, mtime, hash) != GSEA_SUCCESS) {
+        LOG_DEBUG("Manifest entry dropped (out of memory): %s", path);
+    }
+    pthread_mutex_unlock(&m->lock);
+}
+
+int manifest_save(const manifest_t *m, const char *output_dir) {
+    if (!m) {
+        return GSEA_ERROR_ARGS;
+    }
+
+    char path[MAX_PATH_LENGTH];
+    int written = snprintf(path, sizeof(path), "%s/%s", output_dir,
+                           MANIFEST_FILENAME);
+    if (written < 0 || written >= (int)sizeof(path)) {
+        return GSEA_ERROR_FILE;
+    }
+
+    /* Escritura a archivo temporal + rename: una corrida interrumpida no
+       deja un manifiesto a medias */
+    char tmp_path[MAX_PATH_LENGTH];
+    written = snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    if (written < 0 || written >= (int)sizeof(tmp_path)) {
+        return GSEA_ERROR_FILE;
+    }
+
+    FILE *f = fopen(tmp_path, "w");
+    if (!f) {
+        LOG_ERROR("Failed to write manifest: %s", tmp_path);
+        return GSEA_ERROR_FILE;
+    }
+
+    for (size_t i = 0; i < m->capacity; i++) {
+        const manifest_entry_t *entry = &m->entries[i];
+        if (entry->path) {
+            fprintf(f, "%lld %lld %016llx %s\n", (long long)entry->size,
+                    (long long)entry->mtime,
+                    (unsigned long long)entry->hash, entry->path);
+        }
+    }
+
+    fclose(f);
+    if (rename(tmp_path, path) != 0) {
+        LOG_ERROR("Failed to replace manifest: %s", path);
+        return GSEA_ERROR_FILE;
+    }
+    return GSEA_SUCCESS;
+}
+
+void manifest_destroy(manifest_t *m) {
+    if (!m) {
+        return;
+    }
+    for (size_t i = 0; i < m->capacity; i++) {
+        free(m->entries[i].path);
+    }
+    free(m->entries);
+    pthread_mutex_destroy(&m->lock);
+    free(m);
+}
+
+/* ==================== MANIFIESTO ACTIVO ==================== */
+/* El pipeline lo consulta como estado de módulo, igual que el motor de
+   E/S activo: se fija antes de encolar trabajo y los workers solo leen
+   el puntero (los registros van con el lock interno) */
+
+static manifest_t *active_manifest = NULL;
+
+void manifest_set_active(manifest_t *m) {
+    active_manifest = m;
+}
+
+manifest_t *manifest_active(void) {
+    return active_manifest;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file manifest.h
+ * @brief Manifiesto de modo incremental para el procesamiento de directorios
+ * @author Universidad EAFIT - Sistemas Operativos
+ *
+ * @details
+ * Guarda por archivo de entrada su tamaño, mtime y un hash rápido del
+ * contenido, en un archivo de texto junto al directorio de salida. En
+ * corridas siguientes los archivos cuya entrada coincide se saltan sin
+ * releerlos (tamaño + mtime) o tras releerlos (hash, para cubrir touch
+ * sin cambios). --force ignora el manifiesto pero lo sigue actualizando.
+ */
+
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include "../common.h"
+#include <sys/types.h>
+
+/* Nombre del manifiesto dentro del directorio de salida */
+#define MANIFEST_FILENAME ".gsea.manifest"
+
+typedef struct manifest manifest_t;
+
+/**
+ * @brief Carga el manifiesto del directorio de salida
+ * @details Si no existe devuelve un manifiesto vacío (primera corrida).
+ * @param output_dir Directorio de salida del trabajo
+ * @return Manifiesto, o NULL si falla la asignación
+ */
+manifest_t *manifest_load(const char *output_dir);
+
+/**
+ * @brief Hash rápido del contenido (FNV-1a de 64 bits)
+ */
+uint64_t manifest_hash(const uint8_t *data, size_t size);
+
+/**
+ * @brief Ruta rápida: ¿coinciden tamaño y mtime con la entrada registrada?
+ * @details Seguro entre hilos: los checks conviven con workers que
+ *          registran (y la tabla puede crecer bajo sus pies).
+ */
+bool manifest_check(manifest_t *m, const char *path, off_t size,
+                    time_t mtime);
+
+/**
+ * @brief Ruta lenta: ¿coinciden tamaño y hash del contenido ya leído?
+ * @details Cubre archivos con mtime tocado pero contenido idéntico.
+ *          Seguro entre hilos, igual que manifest_check.
+ */
+bool manifest_check_hash(manifest_t *m, const char *path, off_t size,
+                         uint64_t hash);
+
+/**
+ * @brief Registra o refresca la entrada de un archivo procesado
+ * @details Toma el mtime actual con stat. Seguro entre hilos (los workers
+ *          registran concurrentemente).
+ */
+void manifest_record(manifest_t *m, const char *path, off_t size,
+                     uint64_t hash);
+
+/**
+ * @brief Escribe el manifiesto junto al directorio de salida
+ */
+int manifest_save(const manifest_t *m, const char *output_dir);
+
+/**
+ * @brief Libera el manifiesto
+ */
+void manifest_destroy(manifest_t *m);
+
+/**
+ * @brief Fija el manifiesto activo del trabajo en curso
+ * @details El pipeline lo consulta sin pasarlo por cada firma, igual que
+ *          el motor de E/S o la política de fsync. NULL lo desactiva.
+ */
+void manifest_set_active(manifest_t *m);
+
+/**
+ * @brief Manifiesto activo, o NULL si el modo incremental está apagado
+ */
+manifest_t *manifest_active(void);
+
+#endif /* MANIFEST_H */
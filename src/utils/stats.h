@@ -0,0 +1,67 @@
+/**
+ * @file stats.h
+ * @brief Contadores ligeros por etapa del pipeline (modo --stats)
+ * @details Acumuladores atómicos por etapa (lectura, compresión,
+ *          encriptación, escritura...) alimentados desde
+ *          process_file_operations(). Con el modo deshabilitado las
+ *          funciones retornan de inmediato sin tocar el reloj, así el
+ *          camino caliente no paga nada.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include "../common.h"
+
+/* ==============================
+ * Etapas instrumentadas
+ * ============================== */
+typedef enum {
+    STATS_READ,
+    STATS_COMPRESS,
+    STATS_DECOMPRESS,
+    STATS_ENCRYPT,
+    STATS_DECRYPT,
+    STATS_WRITE,
+    STATS_STAGE_COUNT
+} stats_stage_t;
+
+/**
+ * @brief Habilita o deshabilita la recolección de estadísticas
+ */
+void stats_enable(bool enabled);
+
+/**
+ * @brief Indica si la recolección está habilitada
+ */
+bool stats_is_enabled(void);
+
+/**
+ * @brief Reloj monotónico en segundos (independiente de --stats)
+ * @details Pared real, no tiempo de CPU: clock() suma el tiempo de todos
+ *          los hilos y multiplica el reporte por el número de workers
+ */
+double stats_now(void);
+
+/**
+ * @brief Marca el inicio de una etapa
+ * @return Instante monotónico, o 0.0 si la recolección está deshabilitada
+ */
+double stats_begin(void);
+
+/**
+ * @brief Acumula una etapa terminada (no-op si está deshabilitado)
+ * @param stage Etapa del pipeline
+ * @param start Instante retornado por stats_begin()
+ * @param bytes_in Bytes de entrada de la etapa
+ * @param bytes_out Bytes de salida de la etapa
+ */
+void stats_end(stats_stage_t stage, double start,
+               size_t bytes_in, size_t bytes_out);
+
+/**
+ * @brief Imprime el desglose agregado por etapa
+ */
+void stats_report(void);
+
+#endif /* STATS_H */
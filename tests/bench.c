@@ -0,0 +1,295 @@
+/**
+ * @file bench.c
+ * @brief Harness nativo de benchmarks de los codecs GSEA
+ * @details Llama directamente a los codecs sobre corpus en memoria, sin
+ *          pasar por el binario ni por Python, así el número refleja el
+ *          kernel y no el arranque del proceso. Reporta MB/s, ciclos por
+ *          byte (rdtsc en x86) y conteo de asignaciones por operación en
+ *          CSV por stdout, para seguimiento entre releases.
+ *
+ *          Compilar con make bench: el conteo de asignaciones usa
+ *          -Wl,--wrap=malloc/calloc/realloc, que redirige las llamadas
+ *          de los codecs a los contadores de este archivo.
+ *
+ * Uso: gsea_bench [tamaño_corpus_MB]   (por defecto 8)
+ */
+
+#include "../src/common.h"
+#include "../src/compression/lz77.h"
+#include "../src/compression/huffman.h"
+#include "../src/compression/rle.h"
+#include "../src/compression/lzw.h"
+#include "../src/encryption/aes.h"
+#include "../src/encryption/chacha20.h"
+#include "../src/encryption/salsa20.h"
+#include "../src/encryption/rc4.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/* ==============================
+ * Conteo de asignaciones (--wrap)
+ * ============================== */
+
+static size_t alloc_count = 0;
+
+void *__real_malloc(size_t size);
+void *__real_calloc(size_t nmemb, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+
+void *__wrap_malloc(size_t size) {
+    alloc_count++;
+    return __real_malloc(size);
+}
+
+void *__wrap_calloc(size_t nmemb, size_t size) {
+    alloc_count++;
+    return __real_calloc(nmemb, size);
+}
+
+void *__wrap_realloc(void *ptr, size_t size) {
+    alloc_count++;
+    return __real_realloc(ptr, size);
+}
+
+/* ==============================
+ * Medición
+ * ============================== */
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static uint64_t now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/* Flujo del CSV: el stdout original. El fd 1 se redirige a stderr al
+   arrancar para que los LOG_INFO de los codecs no contaminen el CSV */
+static FILE *csv_out;
+
+/**
+ * @brief Emite una fila CSV con las métricas de una operación
+ */
+static void report(const char *codec, const char *op, const char *corpus,
+                   size_t in_bytes, size_t out_bytes, double seconds,
+                   uint64_t cycles, size_t allocs) {
+    double mb_s = (seconds > 0.0)
+                      ? ((double)in_bytes / (1024.0 * 1024.0)) / seconds
+                      : 0.0;
+    double cpb = (in_bytes > 0) ? (double)cycles / (double)in_bytes : 0.0;
+    fprintf(csv_out, "%s,%s,%s,%zu,%zu,%.6f,%.1f,%.2f,%zu\n",
+            codec, op, corpus, in_bytes, out_bytes, seconds, mb_s, cpb, allocs);
+}
+
+/* Firma uniforme de los codecs sobre file_buffer_t */
+typedef int (*codec_fn_t)(const file_buffer_t *, file_buffer_t *);
+typedef int (*cipher_fn_t)(const file_buffer_t *, file_buffer_t *,
+                           const uint8_t *, size_t);
+
+/**
+ * @brief Mide un par compresión/descompresión sobre un corpus
+ */
+static void bench_codec(const char *codec, const char *corpus,
+                        const file_buffer_t *input,
+                        codec_fn_t encode, codec_fn_t decode) {
+    file_buffer_t compressed = {0};
+    file_buffer_t restored = {0};
+
+    alloc_count = 0;
+    double t0 = now_seconds();
+    uint64_t c0 = now_cycles();
+    int result = encode(input, &compressed);
+    uint64_t c1 = now_cycles();
+    double t1 = now_seconds();
+
+    if (result != GSEA_SUCCESS) {
+        fprintf(stderr, "[bench] %s compress failed on %s\n", codec, corpus);
+        return;
+    }
+    report(codec, "compress", corpus, input->size, compressed.size,
+           t1 - t0, c1 - c0, alloc_count);
+
+    alloc_count = 0;
+    t0 = now_seconds();
+    c0 = now_cycles();
+    result = decode(&compressed, &restored);
+    c1 = now_cycles();
+    t1 = now_seconds();
+
+    if (result != GSEA_SUCCESS ||
+        restored.size != input->size ||
+        memcmp(restored.data, input->data, input->size) != 0) {
+        fprintf(stderr, "[bench] %s roundtrip FAILED on %s\n", codec, corpus);
+    } else {
+        report(codec, "decompress", corpus, compressed.size, restored.size,
+               t1 - t0, c1 - c0, alloc_count);
+    }
+
+    free(compressed.data);
+    free(restored.data);
+}
+
+/**
+ * @brief Mide un cifrado sobre un corpus
+ */
+static void bench_cipher(const char *codec, const char *corpus,
+                         const file_buffer_t *input, cipher_fn_t encrypt) {
+    static const uint8_t key[16] = "bench-key-123456";
+    file_buffer_t output = {0};
+
+    alloc_count = 0;
+    double t0 = now_seconds();
+    uint64_t c0 = now_cycles();
+    int result = encrypt(input, &output, key, sizeof(key));
+    uint64_t c1 = now_cycles();
+    double t1 = now_seconds();
+
+    if (result != GSEA_SUCCESS) {
+        fprintf(stderr, "[bench] %s encrypt failed on %s\n", codec, corpus);
+        return;
+    }
+    report(codec, "encrypt", corpus, input->size, output.size,
+           t1 - t0, c1 - c0, alloc_count);
+
+    free(output.data);
+}
+
+/* ==============================
+ * Corpus sintéticos
+ * ============================== */
+
+/**
+ * @brief Texto sintético: palabras repetidas con variación (compresible)
+ */
+static void fill_text(uint8_t *data, size_t size) {
+    static const char *words[] = {
+        "sistema", "archivo", "proceso", "memoria", "kernel",
+        "buffer", "compresion", "pipeline", "syscall", "hilo"
+    };
+    size_t pos = 0;
+    uint32_t state = 12345;
+    while (pos < size) {
+        state = state * 1103515245u + 12345u;
+        const char *w = words[(state >> 16) % 10];
+        size_t len = strlen(w);
+        if (pos + len + 1 > size) break;
+        memcpy(data + pos, w, len);
+        pos += len;
+        data[pos++] = ' ';
+    }
+    while (pos < size) data[pos++] = ' ';
+}
+
+/**
+ * @brief Datos binarios pseudoaleatorios (incompresible)
+ */
+static void fill_binary(uint8_t *data, size_t size) {
+    uint32_t state = 67890;
+    for (size_t i = 0; i < size; i++) {
+        state = state * 1103515245u + 12345u;
+        data[i] = (uint8_t)(state >> 16);
+    }
+}
+
+/**
+ * @brief Rachas largas de bytes repetidos (caso ideal para RLE)
+ */
+static void fill_runs(uint8_t *data, size_t size) {
+    uint32_t state = 24680;
+    size_t pos = 0;
+    while (pos < size) {
+        state = state * 1103515245u + 12345u;
+        uint8_t value = (uint8_t)(state >> 24);
+        size_t run = 16 + ((state >> 8) & 0xFF);
+        if (pos + run > size) run = size - pos;
+        memset(data + pos, value, run);
+        pos += run;
+    }
+}
+
+/* ==============================
+ * Programa principal
+ * ============================== */
+
+int main(int argc, char *argv[]) {
+    size_t corpus_mb = 8;
+    if (argc > 1) {
+        long mb = atol(argv[1]);
+        if (mb <= 0 || mb > 1024) {
+            fprintf(stderr, "Usage: %s [corpus_size_MB (1-1024)]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        corpus_mb = (size_t)mb;
+    }
+    size_t corpus_size = corpus_mb * 1024 * 1024;
+
+    /* Quedarse con el stdout original para el CSV y mandar el fd 1 a
+       stderr: así los LOG_INFO de los codecs no se mezclan con las filas */
+    csv_out = fdopen(dup(STDOUT_FILENO), "w");
+    if (!csv_out) {
+        fprintf(stderr, "Failed to duplicate stdout for CSV output\n");
+        return EXIT_FAILURE;
+    }
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+
+    struct {
+        const char *name;
+        void (*fill)(uint8_t *, size_t);
+        file_buffer_t buf;
+    } corpora[] = {
+        { "text",   fill_text,   {0} },
+        { "binary", fill_binary, {0} },
+        { "runs",   fill_runs,   {0} },
+    };
+    const int corpus_count = (int)(sizeof(corpora) / sizeof(corpora[0]));
+
+    for (int i = 0; i < corpus_count; i++) {
+        corpora[i].buf.data = __real_malloc(corpus_size);
+        if (!corpora[i].buf.data) {
+            fprintf(stderr, "Failed to allocate corpus '%s'\n", corpora[i].name);
+            return EXIT_FAILURE;
+        }
+        corpora[i].buf.size = corpus_size;
+        corpora[i].buf.capacity = corpus_size;
+        corpora[i].fill(corpora[i].buf.data, corpus_size);
+    }
+
+    fprintf(csv_out, "codec,op,corpus,input_bytes,output_bytes,seconds,"
+                     "mb_per_s,cycles_per_byte,allocs\n");
+
+    /* Compresores: los tres corpus para ver el rango compresible/no */
+    for (int i = 0; i < corpus_count; i++) {
+        const char *name = corpora[i].name;
+        const file_buffer_t *buf = &corpora[i].buf;
+        bench_codec("lz77", name, buf, lz77_compress, lz77_decompress);
+        bench_codec("huffman", name, buf, huffman_encode, huffman_decode);
+        bench_codec("rle", name, buf, rle_encode, rle_decode);
+        bench_codec("lzw", name, buf, lzw_encode, lzw_decode);
+    }
+
+    /* Cifrados: velocidad independiente del contenido, basta un corpus */
+    bench_cipher("aes128", "binary", &corpora[1].buf, aes_encrypt);
+    bench_cipher("aes128-ctr", "binary", &corpora[1].buf, aes_encrypt_ctr);
+    bench_cipher("chacha20", "binary", &corpora[1].buf, chacha20_encrypt);
+    bench_cipher("salsa20", "binary", &corpora[1].buf, salsa20_encrypt);
+    bench_cipher("rc4", "binary", &corpora[1].buf, rc4_encrypt);
+
+    for (int i = 0; i < corpus_count; i++) {
+        free(corpora[i].buf.data);
+    }
+
+    fflush(csv_out);
+    return EXIT_SUCCESS;
+}